@@ -0,0 +1,31 @@
+#version 420 core
+layout (location = 0) in vec2 vertex; // unit quad corner
+layout (location = 1) in vec2 offset; // per brick from here on
+layout (location = 2) in vec3 color;
+layout (location = 3) in float solid;
+
+out vec2 TexCoords;
+out vec3 BrickColor;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+uniform vec2 brickSize;
+uniform vec4 regions[2]; // atlas regions of the breakable and solid brick images
+uniform usamplerBuffer destroyed; // one bit per brick, 32 bricks per texel
+
+void main() {
+    vec4 region = regions[int(solid)];
+    TexCoords = region.xy + vertex * region.zw;
+    BrickColor = color;
+
+    uint word = texelFetch(destroyed, gl_InstanceID >> 5).r;
+    if (((word >> uint(gl_InstanceID & 31)) & 1u) != 0u)
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0); // outside the clip volume, so the brick is culled
+    else
+        gl_Position = projection * vec4(offset + vertex * brickSize, 0.0, 1.0);
+}
\ No newline at end of file
@@ -1,16 +1,25 @@
-#version 420 core
+#version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec2 offset; // per particle from here on
+layout (location = 2) in vec4 color;
+layout (location = 3) in float scale;
 
 out vec2 TexCoords;
 out vec4 ParticleColor;
 
-uniform mat4 projection;
-uniform vec2 offset;
-uniform vec4 color;
-uniform float scale;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+uniform vec4 region; // part of the texture the particle image covers (see Texture2D::Region)
 
 void main() {
-    TexCoords = vertex.zw;
+    TexCoords = region.xy + vertex.zw * region.zw;
     ParticleColor = color;
-    gl_Position = projection * vec4((vertex.xy * scale) + offset, 0.0, 1.0);
+    // Faded-out particles (kept in the GPU path's buffers) collapse to nothing
+    float size = color.a > 0.0 ? scale : 0.0;
+    gl_Position = projection * vec4((vertex.xy * size) + offset, 0.0, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#version 330 core
+// Advances one particle of the GPU particle path (ParticleFeedback) per
+// vertex; the outputs are captured into the other state buffer with
+// transform feedback. Dead particles (alpha 0) keep their state until a
+// new particle is written over them.
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 velocity;
+layout (location = 2) in vec4 color;
+layout (location = 3) in float fade;
+layout (location = 4) in float scale;
+
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec4 outColor;
+out float outFade;
+out float outScale;
+
+uniform float dt;
+
+void main() {
+    float step = color.a > 0.0 ? dt : 0.0;
+    outPosition = position + velocity * step;
+    outVelocity = velocity;
+    outColor = vec4(color.rgb, max(color.a - fade * step, 0.0));
+    outFade = fade;
+    outScale = scale;
+}
\ No newline at end of file
@@ -3,10 +3,13 @@ layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
 
 out vec2 TexCoords;
 
-uniform bool  chaos;
-uniform bool  confuse;
-uniform bool  shake;
-uniform float time;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
 
 void main()
 {
@@ -0,0 +1,21 @@
+#version 420 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 texCoords;
+layout (location = 2) in vec3 color;
+
+out vec2 TexCoords;
+out vec3 SpriteColor;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+
+void main() {
+    TexCoords = texCoords;
+    SpriteColor = color;
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+}
\ No newline at end of file
@@ -1,8 +1,14 @@
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #include "Game.h"
+#include "GLState.h"
+#include "ProgramCache.h"
+#include "Replay.h"
 #include "ResourceManager.h"
 
 // GLFW callback functions
@@ -12,6 +18,32 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 const unsigned int SCREEN_WIDTH = 800;
 const unsigned int SCREEN_HEIGHT= 600;
 
+// Simulation runs at a fixed tick rate independent of the render rate.
+// Can be overridden with the first command line argument (e.g. 120 or 240).
+// "--record file" (anywhere on the command line) saves the session as a
+// replay that breakout_sim --replay can re-simulate. "--gpu-particles"
+// simulates the particles on the GPU (see ParticleFeedback). "--gl-stats"
+// prints how many GL state changes a frame issued and how many GLState
+// skipped as redundant, about once a second. Linked shader programs are
+// cached in SHADER_CACHE_DIRECTORY (see ProgramCache); "--no-shader-cache"
+// builds them from source every time.
+const double DEFAULT_TICK_RATE = 240.0;
+
+// Longest frame time the simulation will try to catch up on. Anything above
+// this (debugger breaks, window drags) is dropped instead of being simulated.
+const double MAX_FRAME_TIME = 0.25;
+
+// Ticks between full-state keyframes in recorded replays (10 s at 240 Hz)
+const std::uint32_t REPLAY_KEYFRAME_INTERVAL = 2400;
+
+// Radius of the balls added in stress mode (second command line argument)
+const float STRESS_BALL_RADIUS = 4.0f;
+
+// Seconds between two "--gl-stats" reports
+const double GL_STATS_INTERVAL = 1.0;
+
+const char *const SHADER_CACHE_DIRECTORY = "shader_cache";
+
 Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
 
 int main(int argc, char *argv[])
@@ -43,37 +75,100 @@ int main(int argc, char *argv[])
 	// OpenGL configuration
 	glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
 	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// Split options from positional arguments
+	const char *recordFile = nullptr;
+	bool glStats = false;
+	ProgramCache::Directory = SHADER_CACHE_DIRECTORY;
+	std::vector<const char *> positional;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+			recordFile = argv[++i];
+		else if (std::strcmp(argv[i], "--gpu-particles") == 0)
+			Breakout.GpuParticles = true;
+		else if (std::strcmp(argv[i], "--gl-stats") == 0)
+			glStats = true;
+		else if (std::strcmp(argv[i], "--no-shader-cache") == 0)
+			ProgramCache::Directory.clear();
+		else
+			positional.push_back(argv[i]);
+	}
 
 	// Initialize game
 	Breakout.Init();
+	if (glStats)
+		std::cout << "Shader programs: " << ProgramCache::Hits << " loaded from the cache, "
+			<< ProgramCache::Misses << " built and cached" << std::endl;
+
+	double tickRate = positional.size() > 0 ? std::atof(positional[0]) : DEFAULT_TICK_RATE;
+	if (tickRate <= 0.0)
+		tickRate = DEFAULT_TICK_RATE;
+	const double tickTime = 1.0 / tickRate;
+
+	// Stress mode: the second argument adds that many small balls to the first level
+	int stressBalls = positional.size() > 1 ? std::atoi(positional[1]) : 0;
+	if (stressBalls > 0)
+	{
+		Breakout.Sim.SpawnBalls(static_cast<unsigned int>(stressBalls), STRESS_BALL_RADIUS);
+		// Saving thousands of balls every tick would dominate the frame
+		Breakout.RewindEnabled = false;
+	}
+
+	Replay replay;
+	ReplayRecorder recorder(replay, Random::DEFAULT_SEED, static_cast<float>(tickTime), REPLAY_KEYFRAME_INTERVAL);
+	if (recordFile)
+		Breakout.Recorder = &recorder;
 
-	// Delta time variables
-	float deltaTime = 0.0f;
-	float lastFrame = 0.0f;
+	// Fixed timestep variables (double precision monotonic clock)
+	double lastFrame = glfwGetTime();
+	double accumulator = 0.0;
+	double lastStats = lastFrame;
 
 	while (!glfwWindowShouldClose(window))
 	{
-		// Calculate delta time
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
+		// Calculate frame time
+		double currentFrame = glfwGetTime();
+		double frameTime = currentFrame - lastFrame;
 		lastFrame = currentFrame;
+		if (frameTime > MAX_FRAME_TIME)
+			frameTime = MAX_FRAME_TIME;
+		accumulator += frameTime;
 		glfwPollEvents();
 
-		// Manage user input
-		Breakout.ProcessInput(deltaTime);
+		// GL work of the particle update counts towards the frame as well
+		GLState::BeginFrame();
+		if (glStats && currentFrame - lastStats >= GL_STATS_INTERVAL)
+		{
+			std::cout << "GL state changes per frame: " << GLState::LastFrame.Issued << " issued, "
+				<< GLState::LastFrame.Elided << " elided" << std::endl;
+			lastStats = currentFrame;
+		}
 
-		// Update game state
-		Breakout.Update(deltaTime);
+		// Advance the simulation in fixed steps
+		while (accumulator >= tickTime)
+		{
+			// Manage user input
+			Breakout.ProcessInput(static_cast<float>(tickTime));
 
-		// Render
+			// Update game state
+			Breakout.Update(static_cast<float>(tickTime));
+
+			accumulator -= tickTime;
+		}
+
+		// Render, interpolating between the last two simulation states
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
-		Breakout.Render();
+		Breakout.Render(static_cast<float>(accumulator / tickTime));
 
 		glfwSwapBuffers(window);
 	}
 
+	if (recordFile)
+		replay.Save(recordFile);
+
 	// Delete all loaded resources using the resource manager
 	ResourceManager::Clear();
 
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "3rdParty/stb_image.h"
+
+// Texture atlas packer (atlas_packer target), run as a pre-build step of the
+// breakout project:
+//
+//     atlas_packer output.h atlas.tga name=image...
+//
+// Packs the images into one RGBA atlas image, written as a run-length
+// encoded TGA (which stb_image reads), and writes a header with the pixel
+// rectangle of every image in the atlas under the given name. Load both with
+// ResourceManager::LoadTextureAtlas. Like embed_assets, outputs are only
+// rewritten when their contents change.
+
+// Widest atlas produced; images are packed into rows up to this width
+const unsigned int MAX_ATLAS_WIDTH = 2048;
+
+// Border around every image, filled by repeating its edge pixels so linear
+// filtering at the edge of a region never picks up a neighbouring image
+const unsigned int PADDING = 1;
+
+struct Image
+{
+	std::string Name, Path;
+	int Width = 0, Height = 0;
+	unsigned char *Pixels = nullptr; // RGBA
+	unsigned int X = 0, Y = 0;		 // placement of the padded image
+};
+
+// Derives the header guard from the output file name (TextureAtlas.h -> TEXTURE_ATLAS_H)
+std::string GuardName(const std::string &path)
+{
+	std::size_t start = path.find_last_of("/\\");
+	start = start == std::string::npos ? 0 : start + 1;
+
+	std::string name;
+	for (std::size_t i = start; i < path.size(); ++i)
+	{
+		unsigned char c = static_cast<unsigned char>(path[i]);
+		if (std::isupper(c) && i > start && std::islower(static_cast<unsigned char>(path[i - 1])))
+			name += '_';
+		name += std::isalnum(c) ? static_cast<char>(std::toupper(c)) : '_';
+	}
+	return name;
+}
+
+std::string ForwardSlashes(std::string path)
+{
+	std::replace(path.begin(), path.end(), '\\', '/');
+	return path;
+}
+
+// Places the images on rows, tallest first, and returns the atlas height
+unsigned int Pack(std::vector<Image> &images)
+{
+	std::vector<Image *> order;
+	for (Image &image : images)
+		order.push_back(&image);
+	std::stable_sort(order.begin(), order.end(), [](const Image *a, const Image *b) { return a->Height > b->Height; });
+
+	unsigned int x = 0, y = 0, rowHeight = 0;
+	for (Image *image : order)
+	{
+		unsigned int width = image->Width + 2 * PADDING, height = image->Height + 2 * PADDING;
+		if (x + width > MAX_ATLAS_WIDTH)
+		{
+			x = 0;
+			y += rowHeight;
+			rowHeight = 0;
+		}
+		image->X = x;
+		image->Y = y;
+		x += width;
+		rowHeight = std::max(rowHeight, height);
+	}
+	return y + rowHeight;
+}
+
+// Copies image into the atlas, repeating its edge pixels into the padding
+void Blit(const Image &image, std::vector<unsigned char> &atlas, unsigned int atlasWidth)
+{
+	int paddedWidth = image.Width + 2 * PADDING, paddedHeight = image.Height + 2 * PADDING;
+	for (int y = 0; y < paddedHeight; ++y)
+	{
+		int sourceY = std::min(std::max(y - static_cast<int>(PADDING), 0), image.Height - 1);
+		for (int x = 0; x < paddedWidth; ++x)
+		{
+			int sourceX = std::min(std::max(x - static_cast<int>(PADDING), 0), image.Width - 1);
+			const unsigned char *source = &image.Pixels[(sourceY * image.Width + sourceX) * 4];
+			unsigned char *target = &atlas[((image.Y + y) * atlasWidth + image.X + x) * 4];
+			std::copy_n(source, 4, target);
+		}
+	}
+}
+
+// Encodes RGBA pixels as a run-length encoded, top-down, 32-bit TGA. Packets
+// don't cross rows, as the format asks
+std::string EncodeTga(const std::vector<unsigned char> &pixels, unsigned int width, unsigned int height)
+{
+	std::string tga(18, '\0');
+	tga[2] = 10; // run-length encoded true color
+	tga[12] = static_cast<char>(width & 0xFF);
+	tga[13] = static_cast<char>(width >> 8);
+	tga[14] = static_cast<char>(height & 0xFF);
+	tga[15] = static_cast<char>(height >> 8);
+	tga[16] = 32;
+	tga[17] = 0x28; // 8 alpha bits, first row at the top
+
+	auto pixel = [&pixels, width](unsigned int x, unsigned int y) { return &pixels[(y * width + x) * 4]; };
+	auto same = [&pixel](unsigned int x, unsigned int y) { return std::equal(pixel(x, y), pixel(x, y) + 4, pixel(x + 1, y)); };
+	auto append = [&tga](const unsigned char *rgba) {
+		tga += static_cast<char>(rgba[2]);
+		tga += static_cast<char>(rgba[1]);
+		tga += static_cast<char>(rgba[0]);
+		tga += static_cast<char>(rgba[3]);
+	};
+
+	for (unsigned int y = 0; y < height; ++y)
+	{
+		unsigned int x = 0;
+		while (x < width)
+		{
+			// A run of equal pixels, or else literal pixels up to the next run
+			unsigned int count = 1;
+			if (x + 1 < width && same(x, y))
+			{
+				while (x + count < width && count < 128 && same(x + count - 1, y))
+					++count;
+				tga += static_cast<char>(0x80 | (count - 1));
+				append(pixel(x, y));
+			}
+			else
+			{
+				while (x + count < width && count < 128 && !(x + count + 1 < width && same(x + count, y)))
+					++count;
+				tga += static_cast<char>(count - 1);
+				for (unsigned int i = 0; i < count; ++i)
+					append(pixel(x + i, y));
+			}
+			x += count;
+		}
+	}
+	return tga;
+}
+
+// Writes contents to path unless the file already holds exactly that
+bool WriteIfChanged(const char *path, const std::string &contents)
+{
+	std::ifstream existing(path, std::ios::binary);
+	std::string previous((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+	if (previous == contents)
+		return true;
+
+	std::ofstream output(path, std::ios::binary);
+	output << contents;
+	if (!output)
+	{
+		std::cout << "ERROR::ATLAS: Failed to write " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+	{
+		std::cout << "Usage: atlas_packer output.h atlas.tga name=image..." << std::endl;
+		return -1;
+	}
+
+	std::vector<Image> images;
+	bool loaded = true;
+	for (int i = 3; i < argc && loaded; ++i)
+	{
+		std::string argument = argv[i];
+		std::size_t separator = argument.find('=');
+		if (separator == std::string::npos || separator == 0)
+		{
+			std::cout << "ERROR::ATLAS: Expected name=image, got " << argument << std::endl;
+			loaded = false;
+			break;
+		}
+
+		Image image;
+		image.Name = argument.substr(0, separator);
+		image.Path = ForwardSlashes(argument.substr(separator + 1));
+		int channels;
+		image.Pixels = stbi_load(image.Path.c_str(), &image.Width, &image.Height, &channels, 4);
+		if (!image.Pixels)
+		{
+			std::cout << "ERROR::ATLAS: Failed to load " << image.Path << std::endl;
+			loaded = false;
+		}
+		else if (static_cast<unsigned int>(image.Width) + 2 * PADDING > MAX_ATLAS_WIDTH)
+		{
+			std::cout << "ERROR::ATLAS: " << image.Path << " is wider than the atlas" << std::endl;
+			loaded = false;
+		}
+		images.push_back(image);
+	}
+
+	int result = 1;
+	if (loaded)
+	{
+		unsigned int height = Pack(images);
+		unsigned int width = 0;
+		for (const Image &image : images)
+			width = std::max(width, image.X + image.Width + 2 * PADDING);
+
+		std::vector<unsigned char> atlas(static_cast<std::size_t>(width) * height * 4, 0);
+		for (const Image &image : images)
+			Blit(image, atlas, width);
+
+		std::string guard = GuardName(argv[1]);
+		std::ostringstream header;
+		header << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+		header << "// Generated by atlas_packer from the images named below. Don't edit; edit\n"
+			"// the images and rebuild instead.\n\n";
+		header << "#include \"Texture.h\"\n\n";
+		header << "// " << width << "x" << height << " pixels\n";
+		header << "inline constexpr char TEXTURE_ATLAS_FILE[] = \"" << ForwardSlashes(argv[2]) << "\";\n\n";
+		header << "inline constexpr AtlasRegion TEXTURE_ATLAS_REGIONS[] = {\n";
+		for (const Image &image : images)
+			header << "\t{ \"" << image.Name << "\", " << image.X + PADDING << ", " << image.Y + PADDING << ", "
+				<< image.Width << ", " << image.Height << " }, // " << image.Path << "\n";
+		header << "};\n\n";
+		header << "inline constexpr unsigned int TEXTURE_ATLAS_REGION_COUNT = " << images.size() << ";\n\n";
+		header << "#endif // !" << guard << "\n";
+
+		if (WriteIfChanged(argv[2], EncodeTga(atlas, width, height)) && WriteIfChanged(argv[1], header.str()))
+			result = 0;
+	}
+
+	for (Image &image : images)
+		stbi_image_free(image.Pixels);
+	return result;
+}
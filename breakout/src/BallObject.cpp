@@ -1,52 +1,40 @@
 #include "BallObject.h"
 
 BallObject::BallObject()
-	: GameObject(), Radius(12.5f), Stuck(true), Sticky(false), PassThrough(false)
+	: GameObject(), Radius(12.5f), PreviousPosition(0.0f), Stuck(true), Sticky(false), PassThrough(false)
 {
 }
 
-BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite)
-	: GameObject(pos, glm::vec2(radius * 2.0f, radius * 2.0f), sprite,
-		glm::vec3(1.0f), velocity), Radius(radius), Stuck(true), Sticky(false), PassThrough(false)
+BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity)
+	: GameObject(pos, glm::vec2(radius * 2.0f, radius * 2.0f),
+		glm::vec3(1.0f), velocity), Radius(radius), PreviousPosition(pos), Stuck(true), Sticky(false), PassThrough(false)
 {
 }
 
-glm::vec2 BallObject::Move(float dt, unsigned int window_width)
-{
-	// If not stuck to the player paddle
-	if (!this->Stuck)
-	{
-		// Move the ball
-		this->Position += this->Velocity * dt;
-
-		// Check if outside window bounds
-		// If so, reverse velocity and restore at correct position
-		if (this->Position.x <= 0.0f)
-		{
-			this->Velocity.x = -this->Velocity.x;
-			this->Position.x = 0.0f;
-		}
-		else if (this->Position.x + this->Size.x >= window_width)
-		{
-			this->Velocity.x = -this->Velocity.x;
-			this->Position.x = window_width - this->Size.x;
-		}
-
-		if (this->Position.y <= 0.0f)
-		{
-			this->Velocity.y = -this->Velocity.y;
-			this->Position.y = 0.0f;
-		}
-	}
-
-	return this->Position;
-}
-
 void BallObject::Reset(glm::vec2 position, glm::vec2 velocity)
 {
 	this->Position = position;
+	this->PreviousPosition = position;
 	this->Velocity = velocity;
 	this->Stuck = true;
 	this->Sticky = false;
 	this->PassThrough = false;
 }
+
+void BallObject::Save(ByteWriter &out) const
+{
+	GameObject::Save(out);
+	out.Put(this->Radius);
+	out.Put(this->Stuck);
+	out.Put(this->Sticky);
+	out.Put(this->PassThrough);
+}
+
+bool BallObject::Restore(ByteReader &in)
+{
+	if (!GameObject::Restore(in) || !in.Get(this->Radius) || !in.Get(this->Stuck)
+		|| !in.Get(this->Sticky) || !in.Get(this->PassThrough))
+		return false;
+	this->PreviousPosition = this->Position;
+	return true;
+}
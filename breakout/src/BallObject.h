@@ -4,19 +4,22 @@
 #include <glm/glm.hpp>
 
 #include "GameObject.h"
-#include "Texture.h"
 
 class BallObject : public GameObject
 {
 public:
 	BallObject();
-	BallObject(glm::vec2 pos, float radius , glm::vec2 velocity, Texture2D sprite);
+	BallObject(glm::vec2 pos, float radius, glm::vec2 velocity);
 
-	glm::vec2 Move(float dt, unsigned int window_width);
 	void Reset(glm::vec2 position, glm::vec2 velocity);
 
+	// Gameplay state only; PreviousPosition belongs to the renderer
+	void Save(ByteWriter &out) const;
+	bool Restore(ByteReader &in);
+
 	// Ball state
 	float Radius;
+	glm::vec2 PreviousPosition;	// position at the start of the last tick, for interpolation
 	bool Stuck;
 	bool Sticky, PassThrough;
 
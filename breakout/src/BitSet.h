@@ -0,0 +1,50 @@
+#ifndef BIT_SET_H
+#define BIT_SET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Densely packed, dynamically sized set of flags (64 per word).
+class BitSet
+{
+public:
+	// Packed storage, exposed for bulk operations (copy, compare, memset)
+	std::vector<std::uint64_t> Words;
+
+	// Resizes to the given number of bits, all cleared
+	void Resize(std::size_t bits)
+	{
+		this->Words.assign((bits + 63) / 64, 0);
+		this->bits = bits;
+	}
+
+	std::size_t Size() const { return this->bits; }
+
+	bool Test(std::size_t index) const
+	{
+		return (this->Words[index >> 6] >> (index & 63)) & 1;
+	}
+
+	void Set(std::size_t index)
+	{
+		this->Words[index >> 6] |= std::uint64_t(1) << (index & 63);
+	}
+
+	void Reset(std::size_t index)
+	{
+		this->Words[index >> 6] &= ~(std::uint64_t(1) << (index & 63));
+	}
+
+	// Clears every bit
+	void ResetAll()
+	{
+		std::fill(this->Words.begin(), this->Words.end(), 0);
+	}
+
+private:
+	std::size_t bits = 0;
+};
+
+#endif // !BIT_SET_H
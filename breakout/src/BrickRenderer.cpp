@@ -0,0 +1,152 @@
+#include "BrickRenderer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "GLState.h"
+
+// Per-brick vertex data, in instance order (brick id)
+struct BrickInstance
+{
+	glm::vec2 Offset;
+	glm::vec3 Color;
+	float Solid;
+};
+
+BrickRenderer::BrickRenderer(Shader &shader, const Texture2D &block, const Texture2D &solidBlock)
+	: shader(shader), brickSizeLocation(shader.Uniform("brickSize")), atlas(block)
+{
+	if (block.ID != solidBlock.ID)
+		std::cout << "ERROR::BRICKS: Brick images aren't in the same atlas" << std::endl;
+
+	// Array elements needn't have consecutive locations, so set both at once
+	const glm::vec4 regions[] = { block.Region, solidBlock.Region };
+	this->shader.SetVector4f(this->shader.Uniform("regions"), regions, 2, true);
+
+	this->initRenderData();
+}
+
+BrickRenderer::~BrickRenderer()
+{
+	GLState::DeleteVertexArrays(1, &this->VAO);
+	glDeleteBuffers(1, &this->quadVBO);
+	glDeleteBuffers(1, &this->instanceVBO);
+	glDeleteBuffers(1, &this->destroyedBuffer);
+	GLState::DeleteTextures(1, &this->destroyedTexture);
+}
+
+void BrickRenderer::Upload(const GameLevel &level)
+{
+	this->level = &level;
+	this->brickCount = level.BrickCount();
+	this->brickSize = level.BrickSize;
+
+	std::vector<BrickInstance> instances(this->brickCount);
+	for (unsigned int brick = 0; brick < this->brickCount; ++brick)
+		instances[brick] = { level.BrickPositions[brick], level.BrickColors[brick], level.IsSolid(brick) ? 1.0f : 0.0f };
+
+	glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(BrickInstance), instances.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Allocate at least one texel so the buffer texture is never empty
+	const std::vector<std::uint64_t> &words = level.DestroyedWords();
+	glBindBuffer(GL_TEXTURE_BUFFER, this->destroyedBuffer);
+	glBufferData(GL_TEXTURE_BUFFER, std::max<std::size_t>(words.size(), 1) * sizeof(std::uint64_t), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	this->SyncDestroyed(level);
+}
+
+void BrickRenderer::SyncDestroyed(const GameLevel &level)
+{
+	if (&level != this->level)
+		return;
+
+	// The shader reads the 64-bit words as pairs of 32-bit texels, which on
+	// a little-endian machine keeps brick n at bit n % 32 of texel n / 32
+	const std::vector<std::uint64_t> &words = level.DestroyedWords();
+	glBindBuffer(GL_TEXTURE_BUFFER, this->destroyedBuffer);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, words.size() * sizeof(std::uint64_t), words.data());
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void BrickRenderer::SetDestroyed(const GameLevel &level, unsigned int brick)
+{
+	if (&level != this->level || brick >= this->brickCount)
+		return;
+
+	// The 32-bit half of the 64-bit word that holds the brick's bit
+	std::uint32_t word = static_cast<std::uint32_t>(level.DestroyedWords()[brick / 64] >> (brick % 64 / 32 * 32));
+	glBindBuffer(GL_TEXTURE_BUFFER, this->destroyedBuffer);
+	glBufferSubData(GL_TEXTURE_BUFFER, (brick / 32) * sizeof(std::uint32_t), sizeof(std::uint32_t), &word);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void BrickRenderer::Draw()
+{
+	if (this->brickCount == 0)
+		return;
+
+	this->shader.Use();
+	this->shader.SetVector2f(this->brickSizeLocation, this->brickSize);
+
+	this->atlas.Bind(0);
+	GLState::BindTexture(1, GL_TEXTURE_BUFFER, this->destroyedTexture);
+
+	GLState::BindVertexArray(this->VAO);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, this->brickCount);
+}
+
+void BrickRenderer::initRenderData()
+{
+	// Unit quad; the corner doubles as texture coordinate
+	float vertices[] = {
+		0.0f, 1.0f,
+		1.0f, 0.0f,
+		0.0f, 0.0f,
+
+		0.0f, 1.0f,
+		1.0f, 1.0f,
+		1.0f, 0.0f
+	};
+
+	glGenVertexArrays(1, &this->VAO);
+	glGenBuffers(1, &this->quadVBO);
+	glGenBuffers(1, &this->instanceVBO);
+
+	GLState::BindVertexArray(this->VAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BrickInstance), (void *)offsetof(BrickInstance, Offset));
+	glVertexAttribDivisor(1, 1);
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(BrickInstance), (void *)offsetof(BrickInstance, Color));
+	glVertexAttribDivisor(2, 1);
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(BrickInstance), (void *)offsetof(BrickInstance, Solid));
+	glVertexAttribDivisor(3, 1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::BindVertexArray(0);
+
+	// Destroyed bits, read in the vertex shader through a buffer texture
+	glGenBuffers(1, &this->destroyedBuffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, this->destroyedBuffer);
+	glBufferData(GL_TEXTURE_BUFFER, sizeof(std::uint64_t), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	glGenTextures(1, &this->destroyedTexture);
+	GLState::BindTexture(1, GL_TEXTURE_BUFFER, this->destroyedTexture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, this->destroyedBuffer);
+}
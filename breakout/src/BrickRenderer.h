@@ -0,0 +1,52 @@
+#ifndef BRICK_RENDERER_H
+#define BRICK_RENDERER_H
+
+#include "GameLevel.h"
+#include "Shader.h"
+#include "Texture.h"
+
+// Draws every brick of a level with one instanced draw call. Brick
+// positions, colors and solid/breakable images never change after a level
+// is loaded, so they are uploaded once per level (Upload). Destroyed bricks
+// are hidden by the vertex shader, which reads the level's destroyed bits
+// from a buffer texture; destroying a brick only rewrites the 32-bit word
+// holding its bit (SetDestroyed). Per-frame CPU cost doesn't depend on the
+// number of bricks.
+class BrickRenderer
+{
+public:
+	// block, solidBlock: the breakable and solid brick images, regions of
+	// the same atlas so all bricks draw from one texture
+	BrickRenderer(Shader &shader, const Texture2D &block, const Texture2D &solidBlock);
+	~BrickRenderer();
+
+	// Uploads the layout and destroyed bits of level, replacing the previous one
+	void Upload(const GameLevel &level);
+
+	// Re-uploads all destroyed bits of the uploaded level (after a reset or
+	// a restored snapshot)
+	void SyncDestroyed(const GameLevel &level);
+
+	// Updates the destroyed bit of one brick of the uploaded level
+	void SetDestroyed(const GameLevel &level, unsigned int brick);
+
+	void Draw();
+
+	// The level last uploaded, so callers can tell when to Upload again
+	const GameLevel *Level() const { return this->level; }
+
+private:
+	Shader shader;
+	int brickSizeLocation;
+	Texture2D atlas;
+	unsigned int VAO, quadVBO, instanceVBO;
+	unsigned int destroyedBuffer, destroyedTexture;
+
+	const GameLevel *level = nullptr;
+	unsigned int brickCount = 0;
+	glm::vec2 brickSize = glm::vec2(0.0f);
+
+	void initRenderData();
+};
+
+#endif // !BRICK_RENDERER_H
@@ -0,0 +1,118 @@
+#ifndef BYTE_STREAM_H
+#define BYTE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Minimal binary (de)serialization helpers for state snapshots and replays.
+// Values are stored in native byte order (little endian on every platform
+// the game targets); Varint uses the LEB128 encoding.
+class ByteWriter
+{
+public:
+	std::vector<std::uint8_t> &Data;
+
+	explicit ByteWriter(std::vector<std::uint8_t> &data)
+		: Data(data)
+	{
+	}
+
+	template <typename T>
+	void Put(const T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "ByteWriter::Put needs a trivially copyable type");
+		this->PutBytes(&value, sizeof(T));
+	}
+
+	void PutBytes(const void *bytes, std::size_t size)
+	{
+		const std::uint8_t *begin = static_cast<const std::uint8_t *>(bytes);
+		this->Data.insert(this->Data.end(), begin, begin + size);
+	}
+
+	void PutVarint(std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			this->Data.push_back(static_cast<std::uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		this->Data.push_back(static_cast<std::uint8_t>(value));
+	}
+};
+
+// Reads what ByteWriter wrote. Every getter returns false (and leaves the
+// reader failed) instead of reading past the end.
+class ByteReader
+{
+public:
+	ByteReader(const std::uint8_t *data, std::size_t size)
+		: data(data), size(size), position(0), failed(false)
+	{
+	}
+
+	template <typename T>
+	bool Get(T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "ByteReader::Get needs a trivially copyable type");
+		return this->GetBytes(&value, sizeof(T));
+	}
+
+	bool GetBytes(void *bytes, std::size_t count)
+	{
+		if (this->failed || this->size - this->position < count)
+			return this->fail();
+		std::memcpy(bytes, this->data + this->position, count);
+		this->position += count;
+		return true;
+	}
+
+	bool GetVarint(std::uint64_t &value)
+	{
+		value = 0;
+		for (unsigned int shift = 0; shift < 64; shift += 7)
+		{
+			if (this->failed || this->position == this->size)
+				return this->fail();
+			std::uint8_t byte = this->data[this->position++];
+			value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return this->fail();
+	}
+
+	// Skips count bytes, returning a pointer to them (nullptr past the end)
+	const std::uint8_t *Skip(std::size_t count)
+	{
+		if (this->failed || this->size - this->position < count)
+		{
+			this->fail();
+			return nullptr;
+		}
+		const std::uint8_t *bytes = this->data + this->position;
+		this->position += count;
+		return bytes;
+	}
+
+	std::size_t Position() const { return this->position; }
+	bool AtEnd() const { return this->position == this->size; }
+	bool Failed() const { return this->failed; }
+
+private:
+	const std::uint8_t *data;
+	std::size_t size;
+	std::size_t position;
+	bool failed;
+
+	bool fail()
+	{
+		this->failed = true;
+		return false;
+	}
+};
+
+#endif // !BYTE_STREAM_H
@@ -0,0 +1,266 @@
+#include "Collision.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX2__)
+#define COLLISION_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLLISION_SSE2
+#include <emmintrin.h>
+#endif
+
+bool SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 displacement,
+	glm::vec2 boxMin, glm::vec2 boxMax, SweepHit &hit)
+{
+	// Sweeping a circle against a box is the same as casting its center as a
+	// ray against the box grown by the radius (a rounded rectangle). First
+	// cast against the grown box with the slab method...
+	glm::vec2 grownMin = boxMin - radius;
+	glm::vec2 grownMax = boxMax + radius;
+
+	float tEnter = -FLT_MAX;
+	float tExit = FLT_MAX;
+	int enterAxis = -1;
+
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		if (std::abs(displacement[axis]) < 1e-8f)
+		{
+			// Parallel to this slab, so it must already be inside it
+			if (center[axis] < grownMin[axis] || center[axis] > grownMax[axis])
+				return false;
+			continue;
+		}
+
+		float inverse = 1.0f / displacement[axis];
+		float t1 = (grownMin[axis] - center[axis]) * inverse;
+		float t2 = (grownMax[axis] - center[axis]) * inverse;
+		if (t1 > t2)
+			std::swap(t1, t2);
+
+		if (t1 > tEnter)
+		{
+			tEnter = t1;
+			enterAxis = axis;
+		}
+		tExit = std::min(tExit, t2);
+		if (tEnter > tExit)
+			return false;
+	}
+
+	if (enterAxis == -1 || tEnter > 1.0f || tExit < 0.0f)
+		return false;
+
+	// ...then, if the entry point lies in one of the grown box's corners,
+	// the real shape there is a circle around the box corner
+	glm::vec2 entry = center + displacement * std::max(tEnter, 0.0f);
+	bool outsideX = entry.x < boxMin.x || entry.x > boxMax.x;
+	bool outsideY = entry.y < boxMin.y || entry.y > boxMax.y;
+
+	if (outsideX && outsideY)
+	{
+		glm::vec2 corner(entry.x < boxMin.x ? boxMin.x : boxMax.x,
+			entry.y < boxMin.y ? boxMin.y : boxMax.y);
+
+		// Solve |center + displacement * t - corner| = radius for the smallest t
+		glm::vec2 m = center - corner;
+		float a = glm::dot(displacement, displacement);
+		float b = glm::dot(m, displacement);
+		float c = glm::dot(m, m) - radius * radius;
+		if (c <= 0.0f || b >= 0.0f)
+			return false; // Already touching the corner, or moving away from it
+
+		float discriminant = b * b - a * c;
+		if (discriminant < 0.0f)
+			return false;
+
+		float t = (-b - std::sqrt(discriminant)) / a;
+		if (t < 0.0f || t > 1.0f)
+			return false;
+
+		hit.Time = t;
+		hit.Normal = glm::normalize(center + displacement * t - corner);
+		return true;
+	}
+
+	// Face hit. A negative entry time means we started inside the grown box
+	if (tEnter < 0.0f)
+		return false;
+
+	hit.Time = tEnter;
+	hit.Normal = glm::vec2(0.0f);
+	hit.Normal[enterAxis] = displacement[enterAxis] > 0.0f ? -1.0f : 1.0f;
+	return true;
+}
+
+// Number of set bits in a 4 bit lane mask
+static const unsigned char popCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+// Tests a single box of the batch; shared by the scalar path and SIMD tails
+static inline bool circleAABBOverlap(glm::vec2 center, float radiusSquared,
+	glm::vec2 boxMin, glm::vec2 halfExtents, glm::vec2 &difference)
+{
+	// Same operation order as the SIMD paths so results match bit for bit
+	glm::vec2 fromBox = (center - halfExtents) - boxMin;
+	glm::vec2 clamped = glm::clamp(fromBox, -halfExtents, halfExtents);
+	difference = clamped - fromBox;
+	return glm::dot(difference, difference) <= radiusSquared;
+}
+
+static unsigned int circleAABBBatchTail(glm::vec2 center, float radiusSquared,
+	const glm::vec2 *boxMins, glm::vec2 halfExtents, unsigned int first, unsigned int count,
+	std::uint32_t *hitMask, glm::vec2 *differences)
+{
+	unsigned int hits = 0;
+	for (unsigned int i = first; i < count; ++i)
+	{
+		glm::vec2 difference;
+		if (circleAABBOverlap(center, radiusSquared, boxMins[i], halfExtents, difference))
+		{
+			hitMask[i >> 5] |= 1u << (i & 31);
+			++hits;
+		}
+		if (differences)
+			differences[i] = difference;
+	}
+	return hits;
+}
+
+unsigned int CircleAABBBatchScalar(glm::vec2 center, float radius,
+	const glm::vec2 *boxMins, glm::vec2 boxSize, unsigned int count,
+	std::uint32_t *hitMask, glm::vec2 *differences)
+{
+	std::fill(hitMask, hitMask + (count + 31) / 32, 0u);
+	return circleAABBBatchTail(center, radius * radius, boxMins, boxSize * 0.5f,
+		0, count, hitMask, differences);
+}
+
+#if defined(COLLISION_AVX2)
+
+unsigned int CircleAABBBatch(glm::vec2 center, float radius,
+	const glm::vec2 *boxMins, glm::vec2 boxSize, unsigned int count,
+	std::uint32_t *hitMask, glm::vec2 *differences)
+{
+	std::fill(hitMask, hitMask + (count + 31) / 32, 0u);
+
+	glm::vec2 halfExtents = boxSize * 0.5f;
+	const __m256 halfX = _mm256_set1_ps(halfExtents.x);
+	const __m256 halfY = _mm256_set1_ps(halfExtents.y);
+	const __m256 negHalfX = _mm256_set1_ps(-halfExtents.x);
+	const __m256 negHalfY = _mm256_set1_ps(-halfExtents.y);
+	// Circle center shifted by the half extents, so that subtracting a box's
+	// minimum corner gives the vector from that box's center
+	const __m256 centerX = _mm256_set1_ps(center.x - halfExtents.x);
+	const __m256 centerY = _mm256_set1_ps(center.y - halfExtents.y);
+	const __m256 radiusSquared = _mm256_set1_ps(radius * radius);
+
+	unsigned int hits = 0;
+	unsigned int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		// Load 8 interleaved (x, y) pairs and split them into x and y lanes
+		const float *source = &boxMins[i].x;
+		__m256 a = _mm256_loadu_ps(source);     // x0 y0 x1 y1 | x2 y2 x3 y3
+		__m256 b = _mm256_loadu_ps(source + 8); // x4 y4 x5 y5 | x6 y6 x7 y7
+		__m256 xs = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)); // x0 x1 x4 x5 | x2 x3 x6 x7
+		__m256 ys = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+		xs = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(xs), _MM_SHUFFLE(3, 1, 2, 0)));
+		ys = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(ys), _MM_SHUFFLE(3, 1, 2, 0)));
+
+		// Vector from box center to circle center, clamped to the box
+		__m256 fromBoxX = _mm256_sub_ps(centerX, xs);
+		__m256 fromBoxY = _mm256_sub_ps(centerY, ys);
+		__m256 differenceX = _mm256_sub_ps(_mm256_max_ps(_mm256_min_ps(fromBoxX, halfX), negHalfX), fromBoxX);
+		__m256 differenceY = _mm256_sub_ps(_mm256_max_ps(_mm256_min_ps(fromBoxY, halfY), negHalfY), fromBoxY);
+
+		__m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(differenceX, differenceX),
+			_mm256_mul_ps(differenceY, differenceY));
+		unsigned int mask = static_cast<unsigned int>(
+			_mm256_movemask_ps(_mm256_cmp_ps(distanceSquared, radiusSquared, _CMP_LE_OQ)));
+
+		hitMask[i >> 5] |= mask << (i & 31);
+		hits += popCount[mask & 15] + popCount[mask >> 4];
+
+		if (differences)
+		{
+			__m256 low = _mm256_unpacklo_ps(differenceX, differenceY);  // d0 d1 | d4 d5
+			__m256 high = _mm256_unpackhi_ps(differenceX, differenceY); // d2 d3 | d6 d7
+			float *target = &differences[i].x;
+			_mm256_storeu_ps(target, _mm256_permute2f128_ps(low, high, 0x20));
+			_mm256_storeu_ps(target + 8, _mm256_permute2f128_ps(low, high, 0x31));
+		}
+	}
+
+	return hits + circleAABBBatchTail(center, radius * radius, boxMins, halfExtents,
+		i, count, hitMask, differences);
+}
+
+#elif defined(COLLISION_SSE2)
+
+unsigned int CircleAABBBatch(glm::vec2 center, float radius,
+	const glm::vec2 *boxMins, glm::vec2 boxSize, unsigned int count,
+	std::uint32_t *hitMask, glm::vec2 *differences)
+{
+	std::fill(hitMask, hitMask + (count + 31) / 32, 0u);
+
+	glm::vec2 halfExtents = boxSize * 0.5f;
+	const __m128 halfX = _mm_set1_ps(halfExtents.x);
+	const __m128 halfY = _mm_set1_ps(halfExtents.y);
+	const __m128 negHalfX = _mm_set1_ps(-halfExtents.x);
+	const __m128 negHalfY = _mm_set1_ps(-halfExtents.y);
+	// Circle center shifted by the half extents, so that subtracting a box's
+	// minimum corner gives the vector from that box's center
+	const __m128 centerX = _mm_set1_ps(center.x - halfExtents.x);
+	const __m128 centerY = _mm_set1_ps(center.y - halfExtents.y);
+	const __m128 radiusSquared = _mm_set1_ps(radius * radius);
+
+	unsigned int hits = 0;
+	unsigned int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		// Load 4 interleaved (x, y) pairs and split them into x and y lanes
+		const float *source = &boxMins[i].x;
+		__m128 a = _mm_loadu_ps(source);     // x0 y0 x1 y1
+		__m128 b = _mm_loadu_ps(source + 4); // x2 y2 x3 y3
+		__m128 xs = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 ys = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+		// Vector from box center to circle center, clamped to the box
+		__m128 fromBoxX = _mm_sub_ps(centerX, xs);
+		__m128 fromBoxY = _mm_sub_ps(centerY, ys);
+		__m128 differenceX = _mm_sub_ps(_mm_max_ps(_mm_min_ps(fromBoxX, halfX), negHalfX), fromBoxX);
+		__m128 differenceY = _mm_sub_ps(_mm_max_ps(_mm_min_ps(fromBoxY, halfY), negHalfY), fromBoxY);
+
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(differenceX, differenceX),
+			_mm_mul_ps(differenceY, differenceY));
+		unsigned int mask = static_cast<unsigned int>(
+			_mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared)));
+
+		hitMask[i >> 5] |= mask << (i & 31);
+		hits += popCount[mask];
+
+		if (differences)
+		{
+			float *target = &differences[i].x;
+			_mm_storeu_ps(target, _mm_unpacklo_ps(differenceX, differenceY));
+			_mm_storeu_ps(target + 4, _mm_unpackhi_ps(differenceX, differenceY));
+		}
+	}
+
+	return hits + circleAABBBatchTail(center, radius * radius, boxMins, halfExtents,
+		i, count, hitMask, differences);
+}
+
+#else
+
+unsigned int CircleAABBBatch(glm::vec2 center, float radius,
+	const glm::vec2 *boxMins, glm::vec2 boxSize, unsigned int count,
+	std::uint32_t *hitMask, glm::vec2 *differences)
+{
+	return CircleAABBBatchScalar(center, radius, boxMins, boxSize, count, hitMask, differences);
+}
+
+#endif
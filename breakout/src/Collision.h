@@ -0,0 +1,43 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Result of a swept (continuous) collision query
+struct SweepHit
+{
+	// Fraction of the displacement at which contact happens, in [0, 1]
+	float Time;
+
+	// Contact normal, pointing away from the obstacle
+	glm::vec2 Normal;
+};
+
+// Swept circle vs axis-aligned box (time of impact). Tests a circle moving
+// from center by displacement against the box [boxMin, boxMax] and returns
+// true on the first contact within the move. Circles that already overlap
+// the box, or that are moving away from it, do not report a hit.
+bool SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 displacement,
+	glm::vec2 boxMin, glm::vec2 boxMax, SweepHit &hit);
+
+// Batched circle vs axis-aligned box overlap test. Tests one circle against
+// count boxes of the same size whose minimum corners are stored in boxMins.
+// Bit i of hitMask (count rounded up to a multiple of 32 bits) is set when
+// the circle overlaps box i. If differences is not null, it receives for
+// every box the vector from the circle center to the closest point on the
+// box; for hits, its length is the radius minus the penetration depth.
+// Returns the number of hits.
+//
+// Compares squared distances (no sqrt) and tests 8 boxes per instruction
+// with AVX2, 4 with SSE2, falling back to scalar code elsewhere.
+unsigned int CircleAABBBatch(glm::vec2 center, float radius,
+	const glm::vec2 *boxMins, glm::vec2 boxSize, unsigned int count,
+	std::uint32_t *hitMask, glm::vec2 *differences = nullptr);
+
+// Scalar reference implementation of CircleAABBBatch
+unsigned int CircleAABBBatchScalar(glm::vec2 center, float radius,
+	const glm::vec2 *boxMins, glm::vec2 boxSize, unsigned int count,
+	std::uint32_t *hitMask, glm::vec2 *differences = nullptr);
+
+#endif // !COLLISION_H
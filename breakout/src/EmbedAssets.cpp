@@ -0,0 +1,100 @@
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+// Asset embedder (embed_assets target), run as a pre-build step of the
+// simulation and breakout projects:
+//
+//     embed_assets output.h file...
+//
+// Writes a header holding every file's contents as a string constant named
+// after the file (assets/shaders/sprite_batch.vert -> SPRITE_BATCH_VERT), so
+// the game needs no file access for them at startup. The header is only
+// rewritten when its contents change, so unchanged assets don't trigger a
+// rebuild.
+
+// MSVC limits a single string literal piece to 16 KB; longer files are
+// split into adjacent literals, which the compiler concatenates
+const std::size_t LITERAL_PIECE_SIZE = 8192;
+const char *RAW_DELIMITER = "embed";
+
+std::string ConstantName(const std::string &path)
+{
+	std::size_t start = path.find_last_of("/\\");
+	start = start == std::string::npos ? 0 : start + 1;
+
+	// camelCase and PascalCase words are separated too (EmbeddedLevels.h -> EMBEDDED_LEVELS_H)
+	std::string name;
+	for (std::size_t i = start; i < path.size(); ++i)
+	{
+		unsigned char c = static_cast<unsigned char>(path[i]);
+		if (std::isupper(c) && i > start && std::islower(static_cast<unsigned char>(path[i - 1])))
+			name += '_';
+		name += std::isalnum(c) ? static_cast<char>(std::toupper(c)) : '_';
+	}
+	if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+		name = "_" + name;
+	return name;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		std::cout << "Usage: embed_assets output.h file..." << std::endl;
+		return -1;
+	}
+
+	std::string guard = ConstantName(argv[1]);
+	std::ostringstream header;
+	header << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+	header << "// Generated by embed_assets from the files named below. Don't edit; edit\n"
+		"// the files and rebuild instead.\n\n";
+
+	for (int i = 2; i < argc; ++i)
+	{
+		std::ifstream stream(argv[i], std::ios::binary);
+		if (!stream)
+		{
+			std::cout << "ERROR::EMBED: Failed to open " << argv[i] << std::endl;
+			return 1;
+		}
+		std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		if (contents.find(std::string(")") + RAW_DELIMITER + "\"") != std::string::npos)
+		{
+			std::cout << "ERROR::EMBED: " << argv[i] << " contains the raw string delimiter" << std::endl;
+			return 1;
+		}
+
+		std::string path = argv[i];
+		for (char &c : path)
+			if (c == '\\')
+				c = '/';
+
+		header << "// " << path << "\n";
+		header << "inline constexpr char " << ConstantName(path) << "[] =";
+		if (contents.empty())
+			header << " \"\"";
+		for (std::size_t offset = 0; offset < contents.size(); offset += LITERAL_PIECE_SIZE)
+			header << "\n\tR\"" << RAW_DELIMITER << "(" << contents.substr(offset, LITERAL_PIECE_SIZE) << ")" << RAW_DELIMITER << "\"";
+		header << ";\n\n";
+	}
+	header << "#endif // !" << guard << "\n";
+
+	std::ifstream existing(argv[1], std::ios::binary);
+	std::string previous((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+	if (previous == header.str())
+		return 0;
+
+	std::ofstream output(argv[1], std::ios::binary);
+	output << header.str();
+	if (!output)
+	{
+		std::cout << "ERROR::EMBED: Failed to write " << argv[1] << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,111 @@
+#ifndef EMBEDDED_LEVEL_H
+#define EMBEDDED_LEVEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GameLevel.h"
+#include "LevelFile.h"
+
+// Compile-time parsing of .lvl text embedded by embed_assets (see
+// EmbeddedLevels.h), so levels are plain static tile arrays in the binary.
+// A malformed level breaks the build instead of the load: evaluating one of
+// the throws below isn't a constant expression.
+
+struct LevelShape
+{
+	unsigned int Columns;
+	unsigned int Rows;
+};
+
+template <std::size_t Count>
+struct LevelTiles
+{
+	std::uint8_t Codes[Count];
+};
+
+constexpr bool IsLevelDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// Same rules as ParseLevelText
+constexpr LevelShape MeasureLevelText(const char *text)
+{
+	LevelShape shape = { 0, 0 };
+	unsigned int count = 0;
+	for (const char *p = text; ; ++p)
+	{
+		if (IsLevelDigit(*p))
+		{
+			unsigned int tileCode = 0;
+			for (; IsLevelDigit(*p); ++p)
+			{
+				tileCode = tileCode * 10 + (*p - '0');
+				if (tileCode > MAX_TILE_CODE)
+					throw "unknown tile code";
+			}
+			++count;
+		}
+
+		if (*p == '\n' || *p == '\0')
+		{
+			if (count > 0)
+			{
+				if (shape.Rows > 0 && count != shape.Columns)
+					throw "rows differ in width";
+				shape.Columns = count;
+				++shape.Rows;
+			}
+			count = 0;
+			if (*p == '\0')
+				break;
+		}
+		else if (*p != ' ' && *p != '\t' && *p != '\r')
+			throw "expected a tile code";
+	}
+
+	if (shape.Rows == 0)
+		throw "no tiles";
+	return shape;
+}
+
+template <std::size_t Count>
+constexpr LevelTiles<Count> ParseLevelTiles(const char *text)
+{
+	LevelTiles<Count> tiles = {};
+	std::size_t tile = 0;
+	for (const char *p = text; *p; )
+	{
+		if (!IsLevelDigit(*p))
+		{
+			++p;
+			continue;
+		}
+
+		unsigned int tileCode = 0;
+		for (; IsLevelDigit(*p); ++p)
+			tileCode = tileCode * 10 + (*p - '0');
+		tiles.Codes[tile++] = static_cast<std::uint8_t>(tileCode);
+	}
+	return tiles;
+}
+
+// The level in Text, e.g. EmbeddedLevel<ONE_LVL>::TILES.Codes
+template <const char *Text>
+struct EmbeddedLevel
+{
+	static constexpr LevelShape SHAPE = MeasureLevelText(Text);
+	static constexpr unsigned int COLUMNS = SHAPE.Columns;
+	static constexpr unsigned int ROWS = SHAPE.Rows;
+	static constexpr LevelTiles<COLUMNS * ROWS> TILES = ParseLevelTiles<COLUMNS * ROWS>(Text);
+};
+
+template <const char *Text>
+void LoadEmbeddedLevel(GameLevel &level, unsigned int levelWidth, unsigned int levelHeight)
+{
+	using Level = EmbeddedLevel<Text>;
+	level.LoadTiles(Level::TILES.Codes, Level::COLUMNS, Level::ROWS, levelWidth, levelHeight);
+}
+
+#endif // !EMBEDDED_LEVEL_H
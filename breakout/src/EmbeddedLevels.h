@@ -0,0 +1,50 @@
+#ifndef EMBEDDED_LEVELS_H
+#define EMBEDDED_LEVELS_H
+
+// Generated by embed_assets from the files named below. Don't edit; edit
+// the files and rebuild instead.
+
+// assets/levels/one.lvl
+inline constexpr char ONE_LVL[] =
+	R"embed(5 5 5 5 5 5 5 5 5 5 5 5 5 5 5 	 
+5 5 5 5 5 5 5 5 5 5 5 5 5 5 5 	 
+4 4 4 4 4 0 0 0 0 0 4 4 4 4 4 	 
+4 1 4 1 4 0 0 1 0 0 4 1 4 1 4 	 
+3 3 3 3 3 0 0 0 0 0 3 3 3 3 3 	 
+3 3 1 3 3 3 3 3 3 3 3 3 1 3 3 	 
+2 2 2 2 2 2 2 2 2 2 2 2 2 2 2 	 
+2 2 2 2 2 2 2 2 2 2 2 2 2 2 2 	)embed";
+
+// assets/levels/two.lvl
+inline constexpr char TWO_LVL[] =
+	R"embed(1 1 1 1 1 1 1 1 1 1 1 1 1 1 1 	 
+1 0 5 5 0 5 5 0 5 5 0 5 5 0 1 	 
+1 5 5 5 5 5 5 5 5 5 5 5 5 5 1 	 
+1 0 3 3 0 3 3 0 3 3 0 3 3 0 1 	 
+1 3 3 3 3 3 3 3 3 3 3 3 3 3 1 	 
+1 0 2 2 0 2 2 0 2 2 0 2 2 0 1 	 
+1 2 2 2 2 2 2 2 2 2 2 2 2 2 1 	 
+1 0 1 1 0 1 1 0 1 1 0 1 1 0 1 	)embed";
+
+// assets/levels/three.lvl
+inline constexpr char THREE_LVL[] =
+	R"embed(0 0 0 0 0 0 0 0 0 0 0 0 0 
+0 0 2 0 0 0 0 0 0 0 2 0 0
+0 0 0 2 0 0 0 0 0 2 0 0 0
+0 0 0 5 5 5 5 5 5 5 0 0 0
+0 0 5 5 0 5 5 5 0 5 5 0 0
+0 5 5 5 5 5 5 5 5 5 5 5 0
+0 3 0 1 1 1 1 1 1 1 0 3 0
+0 3 0 3 0 0 0 0 0 3 0 3 0
+0 0 0 0 4 4 0 4 4 0 0 0 0)embed";
+
+// assets/levels/four.lvl
+inline constexpr char FOUR_LVL[] =
+	R"embed(1 2 1 2 1 2 1 2 1 2 1 2 1
+2 2 2 2 2 2 2 2 2 2 2 2 2
+2 1 3 1 4 1 5 1 4 1 3 1 2
+2 3 3 4 4 5 5 5 4 4 3 3 2
+2 1 3 1 4 1 5 1 4 1 3 1 2
+2 2 3 3 4 4 5 4 4 3 3 2 2)embed";
+
+#endif // !EMBEDDED_LEVELS_H
@@ -0,0 +1,255 @@
+#ifndef EMBEDDED_SHADERS_H
+#define EMBEDDED_SHADERS_H
+
+// Generated by embed_assets from the files named below. Don't edit; edit
+// the files and rebuild instead.
+
+// assets/shaders/brick.vert
+inline constexpr char BRICK_VERT[] =
+	R"embed(#version 420 core
+layout (location = 0) in vec2 vertex; // unit quad corner
+layout (location = 1) in vec2 offset; // per brick from here on
+layout (location = 2) in vec3 color;
+layout (location = 3) in float solid;
+
+out vec2 TexCoords;
+out vec3 BrickColor;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+uniform vec2 brickSize;
+uniform vec4 regions[2]; // atlas regions of the breakable and solid brick images
+uniform usamplerBuffer destroyed; // one bit per brick, 32 bricks per texel
+
+void main() {
+    vec4 region = regions[int(solid)];
+    TexCoords = region.xy + vertex * region.zw;
+    BrickColor = color;
+
+    uint word = texelFetch(destroyed, gl_InstanceID >> 5).r;
+    if (((word >> uint(gl_InstanceID & 31)) & 1u) != 0u)
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0); // outside the clip volume, so the brick is culled
+    else
+        gl_Position = projection * vec4(offset + vertex * brickSize, 0.0, 1.0);
+})embed";
+
+// assets/shaders/brick.frag
+inline constexpr char BRICK_FRAG[] =
+	R"embed(#version 420 core
+in vec2 TexCoords;
+in vec3 BrickColor;
+out vec4 color;
+
+uniform sampler2D image;
+
+void main() {
+    color = vec4(BrickColor, 1.0) * texture(image, TexCoords);
+})embed";
+
+// assets/shaders/sprite_batch.vert
+inline constexpr char SPRITE_BATCH_VERT[] =
+	R"embed(#version 420 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 texCoords;
+layout (location = 2) in vec3 color;
+
+out vec2 TexCoords;
+out vec3 SpriteColor;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+
+void main() {
+    TexCoords = texCoords;
+    SpriteColor = color;
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+})embed";
+
+// assets/shaders/sprite_batch.frag
+inline constexpr char SPRITE_BATCH_FRAG[] =
+	R"embed(#version 420 core
+in vec2 TexCoords;
+in vec3 SpriteColor;
+out vec4 color;
+
+uniform sampler2D image;
+
+void main() {
+    color = vec4(SpriteColor, 1.0) * texture(image, TexCoords);
+})embed";
+
+// assets/shaders/particle.vert
+inline constexpr char PARTICLE_VERT[] =
+	R"embed(#version 330 core
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec2 offset; // per particle from here on
+layout (location = 2) in vec4 color;
+layout (location = 3) in float scale;
+
+out vec2 TexCoords;
+out vec4 ParticleColor;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+uniform vec4 region; // part of the texture the particle image covers (see Texture2D::Region)
+
+void main() {
+    TexCoords = region.xy + vertex.zw * region.zw;
+    ParticleColor = color;
+    // Faded-out particles (kept in the GPU path's buffers) collapse to nothing
+    float size = color.a > 0.0 ? scale : 0.0;
+    gl_Position = projection * vec4((vertex.xy * size) + offset, 0.0, 1.0);
+})embed";
+
+// assets/shaders/particle.frag
+inline constexpr char PARTICLE_FRAG[] =
+	R"embed(#version 330 core
+in vec2 TexCoords;
+in vec4 ParticleColor;
+
+out vec4 color;
+
+uniform sampler2D sprite;
+
+void main() {
+    color = (texture(sprite, TexCoords) * ParticleColor);
+})embed";
+
+// assets/shaders/particle_update.vert
+inline constexpr char PARTICLE_UPDATE_VERT[] =
+	R"embed(#version 330 core
+// Advances one particle of the GPU particle path (ParticleFeedback) per
+// vertex; the outputs are captured into the other state buffer with
+// transform feedback. Dead particles (alpha 0) keep their state until a
+// new particle is written over them.
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 velocity;
+layout (location = 2) in vec4 color;
+layout (location = 3) in float fade;
+layout (location = 4) in float scale;
+
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec4 outColor;
+out float outFade;
+out float outScale;
+
+uniform float dt;
+
+void main() {
+    float step = color.a > 0.0 ? dt : 0.0;
+    outPosition = position + velocity * step;
+    outVelocity = velocity;
+    outColor = vec4(color.rgb, max(color.a - fade * step, 0.0));
+    outFade = fade;
+    outScale = scale;
+})embed";
+
+// assets/shaders/post_processing.vert
+inline constexpr char POST_PROCESSING_VERT[] =
+	R"embed(#version 420 core
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+
+out vec2 TexCoords;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+
+void main()
+{
+    gl_Position = vec4(vertex.xy, 0.0f, 1.0f); 
+    vec2 texture = vertex.zw;
+    if (chaos)
+    {
+        float strength = 0.3;
+        vec2 pos = vec2(texture.x + sin(time) * strength, texture.y + cos(time) * strength);        
+        TexCoords = pos;
+    }
+    else if (confuse)
+    {
+        TexCoords = vec2(1.0 - texture.x, 1.0 - texture.y);
+    }
+    else
+    {
+        TexCoords = texture;
+    }
+    if (shake)
+    {
+        float strength = 0.01;
+        gl_Position.x += cos(time * 10) * strength;        
+        gl_Position.y += cos(time * 15) * strength;        
+    }
+}  )embed";
+
+// assets/shaders/post_processing.frag
+inline constexpr char POST_PROCESSING_FRAG[] =
+	R"embed(#version 420 core
+in  vec2  TexCoords;
+out vec4  color;
+  
+uniform sampler2D scene;
+uniform vec2      offsets[9];
+uniform int       edge_kernel[9];
+uniform float     blur_kernel[9];
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    float time;
+    bool confuse;
+    bool chaos;
+    bool shake;
+};
+
+void main()
+{
+    color = vec4(0.0f);
+    vec3 samples[9];
+    // sample from texture offsets if using convolution matrix
+    if(chaos || shake)
+        for(int i = 0; i < 9; i++)
+            samples[i] = vec3(texture(scene, TexCoords.st + offsets[i]));
+
+    // process effects
+    if (chaos)
+    {           
+        for(int i = 0; i < 9; i++)
+            color += vec4(samples[i] * edge_kernel[i], 0.0f);
+        color.a = 1.0f;
+    }
+    else if (confuse)
+    {
+        color = vec4(1.0 - texture(scene, TexCoords).rgb, 1.0);
+    }
+    else if (shake)
+    {
+        for(int i = 0; i < 9; i++)
+            color += vec4(samples[i] * blur_kernel[i], 0.0f);
+        color.a = 1.0f;
+    }
+    else
+    {
+        color =  texture(scene, TexCoords);
+    }
+})embed";
+
+#endif // !EMBEDDED_SHADERS_H
@@ -0,0 +1,28 @@
+#include "FrameUniforms.h"
+
+#include <glad/glad.h>
+
+#include "Shader.h"
+
+static_assert(sizeof(FrameData) == 80, "FrameData must match the std140 layout of the FrameData block");
+
+FrameUniforms::FrameUniforms()
+{
+	glGenBuffers(1, &this->UBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+FrameUniforms::~FrameUniforms()
+{
+	glDeleteBuffers(1, &this->UBO);
+}
+
+void FrameUniforms::Upload()
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, this->UBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &this->Data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, Shader::FRAME_DATA_BINDING, this->UBO);
+}
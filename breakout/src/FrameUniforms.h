@@ -0,0 +1,40 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glm/glm.hpp>
+
+// Contents of the FrameData uniform block, in std140 layout. Every shader
+// that needs one of these declares the same block:
+//
+//     layout (std140) uniform FrameData {
+//         mat4 projection;
+//         float time;
+//         bool confuse;
+//         bool chaos;
+//         bool shake;
+//     };
+struct FrameData
+{
+	glm::mat4 Projection = glm::mat4(1.0f);
+	float Time = 0.0f;
+	int Confuse = 0, Chaos = 0, Shake = 0; // std140 bools take 4 bytes
+};
+
+// Uniform buffer holding the FrameData shared by all shaders. Fill in Data
+// and Upload once per frame instead of setting the values on every program.
+class FrameUniforms
+{
+public:
+	FrameData Data;
+
+	FrameUniforms();
+	~FrameUniforms();
+
+	// Copies Data into the buffer and binds it to Shader::FRAME_DATA_BINDING
+	void Upload();
+
+private:
+	unsigned int UBO;
+};
+
+#endif // !FRAME_UNIFORMS_H
@@ -0,0 +1,160 @@
+#include "GLState.h"
+
+#include <glad/glad.h>
+
+// Stands for "not known": never a valid name or enum, so the next change is issued
+static const unsigned int UNKNOWN = ~0u;
+
+// Texture units and targets that are cached; anything else is always issued
+static const unsigned int TEXTURE_UNITS = 16;
+static const unsigned int TEXTURE_TARGETS[] = { GL_TEXTURE_2D, GL_TEXTURE_BUFFER };
+static const unsigned int TEXTURE_TARGET_COUNT = sizeof(TEXTURE_TARGETS) / sizeof(TEXTURE_TARGETS[0]);
+
+// Starts out as the state of a new context
+static unsigned int program = 0;
+static unsigned int activeUnit = 0;
+static unsigned int textures[TEXTURE_UNITS][TEXTURE_TARGET_COUNT] = {};
+static unsigned int vertexArray = 0;
+static unsigned int readFramebuffer = 0, drawFramebuffer = 0;
+static unsigned int blendSource = GL_ONE, blendDestination = GL_ZERO;
+
+GLState::Counters GLState::Frame;
+GLState::Counters GLState::LastFrame;
+
+// Returns the index of target in TEXTURE_TARGETS, or TEXTURE_TARGET_COUNT
+static unsigned int textureTargetIndex(unsigned int target)
+{
+	unsigned int index = 0;
+	while (index < TEXTURE_TARGET_COUNT && TEXTURE_TARGETS[index] != target)
+		++index;
+	return index;
+}
+
+// Counts a state change and returns whether it has to be sent to GL
+static bool changes(unsigned int &current, unsigned int value)
+{
+	if (current == value)
+	{
+		++GLState::Frame.Elided;
+		return false;
+	}
+	current = value;
+	++GLState::Frame.Issued;
+	return true;
+}
+
+void GLState::BeginFrame()
+{
+	LastFrame = Frame;
+	Frame = Counters();
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+	if (changes(::program, program))
+		glUseProgram(program);
+}
+
+void GLState::BindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+	unsigned int index = textureTargetIndex(target);
+	if (unit < TEXTURE_UNITS && index < TEXTURE_TARGET_COUNT)
+	{
+		if (!changes(textures[unit][index], texture))
+			return;
+	}
+	else
+		++Frame.Issued;
+
+	// Selecting the unit counts as a change of its own
+	if (changes(activeUnit, unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(target, texture);
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray)
+{
+	if (changes(::vertexArray, vertexArray))
+		glBindVertexArray(vertexArray);
+}
+
+void GLState::BindFramebuffer(unsigned int target, unsigned int framebuffer)
+{
+	bool read = target != GL_DRAW_FRAMEBUFFER;
+	bool draw = target != GL_READ_FRAMEBUFFER;
+	if ((!read || readFramebuffer == framebuffer) && (!draw || drawFramebuffer == framebuffer))
+	{
+		++Frame.Elided;
+		return;
+	}
+
+	if (read)
+		readFramebuffer = framebuffer;
+	if (draw)
+		drawFramebuffer = framebuffer;
+	++Frame.Issued;
+	glBindFramebuffer(target, framebuffer);
+}
+
+void GLState::BlendFunc(unsigned int source, unsigned int destination)
+{
+	if (blendSource == source && blendDestination == destination)
+	{
+		++Frame.Elided;
+		return;
+	}
+
+	blendSource = source;
+	blendDestination = destination;
+	++Frame.Issued;
+	glBlendFunc(source, destination);
+}
+
+void GLState::DeleteProgram(unsigned int program)
+{
+	if (::program == program)
+		::program = 0;
+	glDeleteProgram(program);
+}
+
+void GLState::DeleteTextures(int count, const unsigned int *textures)
+{
+	for (int i = 0; i < count; ++i)
+		for (unsigned int unit = 0; unit < TEXTURE_UNITS; ++unit)
+			for (unsigned int &bound : ::textures[unit])
+				if (bound == textures[i])
+					bound = 0;
+	glDeleteTextures(count, textures);
+}
+
+void GLState::DeleteVertexArrays(int count, const unsigned int *vertexArrays)
+{
+	for (int i = 0; i < count; ++i)
+		if (vertexArray == vertexArrays[i])
+			vertexArray = 0;
+	glDeleteVertexArrays(count, vertexArrays);
+}
+
+void GLState::DeleteFramebuffers(int count, const unsigned int *framebuffers)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		if (readFramebuffer == framebuffers[i])
+			readFramebuffer = 0;
+		if (drawFramebuffer == framebuffers[i])
+			drawFramebuffer = 0;
+	}
+	glDeleteFramebuffers(count, framebuffers);
+}
+
+void GLState::Invalidate()
+{
+	program = UNKNOWN;
+	activeUnit = UNKNOWN;
+	for (unsigned int unit = 0; unit < TEXTURE_UNITS; ++unit)
+		for (unsigned int &bound : textures[unit])
+			bound = UNKNOWN;
+	vertexArray = UNKNOWN;
+	readFramebuffer = drawFramebuffer = UNKNOWN;
+	blendSource = blendDestination = UNKNOWN;
+}
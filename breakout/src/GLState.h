@@ -0,0 +1,46 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+// A static cache in front of the GL state the renderer changes all the time:
+// the program, texture bindings per unit, the vertex array, the framebuffers
+// and the blend function. Every module changes that state through here, so a
+// call that would set what is already set is skipped. Deleting an object
+// through here forgets it, as GL rebinds 0 when a bound object is deleted.
+// Like ResourceManager, all functions are static.
+class GLState
+{
+public:
+	// State changes asked for during a frame: sent to GL, or skipped
+	struct Counters
+	{
+		unsigned int Issued = 0;
+		unsigned int Elided = 0;
+	};
+
+	// Counts of the frame in progress and of the last complete one
+	static Counters Frame, LastFrame;
+
+	// Starts counting a new frame
+	static void BeginFrame();
+
+	static void UseProgram(unsigned int program);
+	// Binds texture to target on the given unit, selecting the unit if needed
+	static void BindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+	static void BindVertexArray(unsigned int vertexArray);
+	// target: GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER
+	static void BindFramebuffer(unsigned int target, unsigned int framebuffer);
+	static void BlendFunc(unsigned int source, unsigned int destination);
+
+	static void DeleteProgram(unsigned int program);
+	static void DeleteTextures(int count, const unsigned int *textures);
+	static void DeleteVertexArrays(int count, const unsigned int *vertexArrays);
+	static void DeleteFramebuffers(int count, const unsigned int *framebuffers);
+
+	// Forgets everything, for after GL calls that bypass GLState
+	static void Invalidate();
+
+private:
+	GLState() {}
+};
+
+#endif // !GL_STATE_H
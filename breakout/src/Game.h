@@ -1,92 +1,85 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include <vector>
 #include <irrKlang/irrKlang.h>
 
-#include "SpriteRenderer.h"
-#include "GameLevel.h"
-#include "BallObject.h"
+#include "Simulation.h"
+#include "Replay.h"
+#include "RewindBuffer.h"
+#include "BrickRenderer.h"
+#include "FrameUniforms.h"
+#include "SpriteBatch.h"
 #include "ParticleGenerator.h"
 #include "PostProcessor.h"
-#include "PowerUp.h"
-
-enum GameState
-{
-	GAME_ACTIVE,
-	GAME_MENU,
-	GAME_WIN
-};
-
-enum Direction
-{
-	UP,
-	RIGHT,
-	DOWN,
-	LEFT
-};
-
-typedef std::tuple<bool, Direction, glm::vec2> Collision;
 
+// Windowed front-end for the Simulation: owns the renderer, audio and
+// effects, translates key state into SimInput and reacts to SimEvents.
 class Game
 {
 public:
 	Game(unsigned int width, unsigned int height);
 	~Game();
 	
-	GameState State;
 	bool Keys[1024];
 	int Width;
 	int Height;
-	SpriteRenderer *Renderer;
+	SpriteBatch *Sprites;
+	// Projection, time and effect flags for all shaders, uploaded once per frame
+	FrameUniforms *Uniforms;
+	BrickRenderer *Bricks;
 	irrklang::ISoundEngine* SoundEngine = irrklang::createIrrKlangDevice();
 
-	std::vector<GameLevel> Levels;
-	unsigned int currentLevel;
+	// Gameplay state (player, ball, levels, power-ups)
+	Simulation Sim;
+
+	// Records every tick's input when set (see Application.cpp --record)
+	ReplayRecorder *Recorder = nullptr;
 
-	GameObject *Player;
-	BallObject *Ball;
+	// Last REWIND_TICKS states; holding backspace steps back through them.
+	// Not available while recording a replay
+	static const unsigned int REWIND_TICKS = 2400; // 10 s at 240 Hz
+	bool RewindEnabled = true;
+	RewindBuffer History;
 
 	ParticleGenerator *Particles;
+	// Simulate particles on the GPU with transform feedback (set before Init,
+	// see Application.cpp --gpu-particles)
+	bool GpuParticles = false;
+	// Trail of the primary ball, and the burst of a destroyed brick
+	ParticleEmitter BallTrail, BrickBurst;
+	static const unsigned int BRICK_BURST_PARTICLES = 24;
 	
 	PostProcessor *Effects;
-	float EffectsShakeTime = 0.0f;
-
-	std::vector<PowerUp> PowerUps;
-
-	// Initial values for the player paddle
-	const glm::vec2 PLAYER_SIZE;
-	const float PLAYER_VELOCITY;
-
-	// Initial values for the ball
-	const float BALL_RADIUS;
-	const glm::vec2 INITIAL_BALL_VELOCITY;
 
 	// Initialize game state (load all shaders/textures/levels)
 	void Init();
 
-	// Game loop
+	// Game loop. ProcessInput and Update advance the simulation by one
+	// fixed tick; Render draws the state interpolated between the previous
+	// and the current tick (alpha in [0, 1])
 	void ProcessInput(float dt);
 	void Update(float dt);
-	void Render();
-	void DoCollisions();
+	void Render(float alpha = 1.0f);
 
-	void ResetLevel();
-	void ResetPlayer();
+	// Complete mutable game state as a flat blob (see Simulation::Save)
+	void SaveState(std::vector<std::uint8_t> &out) const;
+	bool RestoreState(const std::uint8_t *data, std::size_t size);
 
-	void SpawnPowerUps(GameObject& block);
-	void ActivatePowerUp(PowerUp& powerUp);
-	void UpdatePowerUps(float dt);
-	bool IsOtherPowerUpActive(std::vector<PowerUp>& powerUps, std::string type);
+private:
+	// Paddle position at the start of the current tick, used for interpolation
+	// (balls keep their own in BallObject::PreviousPosition)
+	glm::vec2 previousPlayerPosition;
+	float tickDelta = 0.0f;
 
-	// Collisions
-	// AABB - AABB collision (axis-aligned bounding box)
-	bool CheckCollision(GameObject &one, GameObject &two);
+	// Rewinding instead of simulating this tick, and the state buffer used for it
+	bool rewinding = false;
+	std::vector<std::uint8_t> stateScratch;
 
-	// AABB - Circle collision
-	Collision CheckCollision(BallObject &one, GameObject &two);
+	// Texture of each power-up type, indexed by PowerUpType
+	Texture2D *powerUpTextures[POWERUP_TYPE_COUNT];
 
-	Direction VectorDirection(glm::vec2 target);
+	// React (sounds, interpolation resets) to everything that happened during the last tick
+	void HandleEvents();
 };
 
 #endif // !GAME_H
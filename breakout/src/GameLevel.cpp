@@ -1,97 +1,204 @@
 #include "GameLevel.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
-#include <sstream>
-#include "ResourceManager.h"
+#include <iostream>
+#include <iterator>
+#include <string>
 
-void GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int levelHeight)
-{
-	// Clear old data
-	this->Bricks.clear();
+#include "Collision.h"
+#include "LevelFile.h"
+
+const int GameLevel::EMPTY_CELL;
 
-	// Load from file
-	unsigned int tileCode;
-	GameLevel level;
+bool GameLevel::Load(const char *file, unsigned int levelWidth, unsigned int levelHeight)
+{
+	this->clear();
 
-	std::string line;
-	std::ifstream fstream(file);
+	unsigned int columns = 0, rows = 0;
+	std::string error;
 
-	std::vector<std::vector<unsigned int>> tileData;
-	if (fstream)
+	std::size_t length = std::strlen(file);
+	if (length >= 5 && std::strcmp(file + length - 5, ".lvlb") == 0)
 	{
-		while (std::getline(fstream, line)) // Read each line from level file
+		// Compiled level: the tiles are used straight from the mapping
+		MappedFile mapped;
+		if (!mapped.Open(file))
 		{
-			std::istringstream sstream(line);
-			std::vector<unsigned int> row;
-			while (sstream >> tileCode) // Read each word seperated by spaces
-				row.push_back(tileCode);
-			tileData.push_back(row);
+			std::cout << "ERROR::LEVEL: Failed to open level file " << file << std::endl;
+			return false;
 		}
+		const std::uint8_t *tiles = ReadLevelBinary(mapped.Data(), mapped.Size(), columns, rows, error);
+		if (!tiles)
+		{
+			std::cout << "ERROR::LEVEL: " << file << ": " << error << std::endl;
+			return false;
+		}
+		this->LoadTiles(tiles, columns, rows, levelWidth, levelHeight);
+		return true;
+	}
+
+	std::ifstream fstream(file, std::ios::binary);
+	if (!fstream)
+	{
+		std::cout << "ERROR::LEVEL: Failed to open level file " << file << std::endl;
+		return false;
+	}
+	std::string text((std::istreambuf_iterator<char>(fstream)), std::istreambuf_iterator<char>());
 
-		if (tileData.size() > 0)
-			this->Init(tileData, levelWidth, levelHeight);
+	std::vector<std::uint8_t> tiles;
+	if (!ParseLevelText(text.data(), text.size(), tiles, columns, rows, error))
+	{
+		std::cout << "ERROR::LEVEL: " << file << ": " << error << std::endl;
+		return false;
 	}
+	this->LoadTiles(tiles.data(), columns, rows, levelWidth, levelHeight);
+	return true;
 }
 
-void GameLevel::Draw(SpriteRenderer &renderer)
+void GameLevel::Reset()
 {
-	for (GameObject &tile : this->Bricks)
-		if (!tile.Destroyed)
-			tile.Draw(renderer);
+	this->destroyed.ResetAll();
+	this->remainingBricks = this->breakableBricks;
 }
 
-bool GameLevel::IsCompleted()
+void GameLevel::DestroyBrick(unsigned int brick)
 {
-	for (GameObject &tile : this->Bricks)
-		if (!tile.IsSolid && !tile.Destroyed)
-			return false;
-	return true;
+	if (this->solid.Test(brick) || this->destroyed.Test(brick))
+		return;
+
+	this->destroyed.Set(brick);
+	--this->remainingBricks;
 }
 
-void GameLevel::Init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight)
+void GameLevel::RestoreDestroyedWords(const void *bytes)
 {
+	std::memcpy(this->destroyed.Words.data(), bytes, this->destroyed.Words.size() * sizeof(std::uint64_t));
+
+	this->remainingBricks = 0;
+	for (unsigned int brick = 0; brick < this->BrickCount(); ++brick)
+		if (!this->solid.Test(brick) && !this->destroyed.Test(brick))
+			++this->remainingBricks;
+}
+
+void GameLevel::QueryBricks(glm::vec2 center, float radius, std::vector<unsigned int> &result) const
+{
+	if (this->Cells.empty())
+		return;
+
+	// Convert the circle's bounds to an inclusive cell range, clamped to the grid
+	int minX = static_cast<int>(std::floor((center.x - radius) / this->UnitWidth));
+	int minY = static_cast<int>(std::floor((center.y - radius) / this->UnitHeight));
+	int maxX = static_cast<int>(std::floor((center.x + radius) / this->UnitWidth));
+	int maxY = static_cast<int>(std::floor((center.y + radius) / this->UnitHeight));
+
+	minX = std::max(minX, 0);
+	minY = std::max(minY, 0);
+	maxX = std::min(maxX, static_cast<int>(this->Columns) - 1);
+	maxY = std::min(maxY, static_cast<int>(this->Rows) - 1);
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		// Bricks are numbered row by row, so the occupied cells of this row
+		// between minX and maxX hold one contiguous range of brick ids
+		const int *row = &this->Cells[y * this->Columns];
+		int x0 = minX, x1 = maxX;
+		while (x0 <= x1 && row[x0] == EMPTY_CELL)
+			++x0;
+		while (x1 >= x0 && row[x1] == EMPTY_CELL)
+			--x1;
+		if (x0 > x1)
+			continue;
+
+		unsigned int first = static_cast<unsigned int>(row[x0]);
+		unsigned int end = static_cast<unsigned int>(row[x1]) + 1;
+
+		for (unsigned int batch = first; batch < end; batch += 32)
+		{
+			unsigned int count = std::min(end - batch, 32u);
+			std::uint32_t hits;
+			if (CircleAABBBatch(center, radius, &this->BrickPositions[batch], this->BrickSize, count, &hits) == 0)
+				continue;
+
+			for (unsigned int i = 0; i < count; ++i)
+				if ((hits >> i) & 1 && !this->destroyed.Test(batch + i))
+					result.push_back(batch + i);
+		}
+	}
+}
+
+void GameLevel::LoadTiles(const std::uint8_t *tiles, unsigned int columns, unsigned int rows,
+						  unsigned int levelWidth, unsigned int levelHeight)
+{
+	this->clear();
+
 	// Calculate dimensions
-	unsigned int height = tileData.size();
-	unsigned int width = tileData[0].size();
+	unsigned int width = columns;
+	unsigned int height = rows;
 	float unit_width = levelWidth / static_cast<float>(width);
 	float unit_height = levelHeight/ static_cast<float>(height);
 
-	// initialize level tiles based on tileData
+	this->Columns = width;
+	this->Rows = height;
+	this->UnitWidth = unit_width;
+	this->UnitHeight = unit_height;
+	this->Cells.assign(static_cast<std::size_t>(width) * height, EMPTY_CELL);
+	this->BrickSize = glm::vec2(unit_width, unit_height);
+
+	std::size_t tileCount = static_cast<std::size_t>(width) * height;
+	std::size_t brickCount = tileCount - std::count(tiles, tiles + tileCount, 0);
+	this->BrickPositions.reserve(brickCount);
+	this->BrickColors.reserve(brickCount);
+	this->solid.Resize(brickCount);
+	this->destroyed.Resize(brickCount);
+
+	// initialize level tiles based on tile codes
 	for (size_t y = 0; y < height; ++y)
 	{
 		for (size_t x = 0; x < width; ++x)
 		{
 			// Check block type from level data (2D level array)
-			if (tileData[y][x] == 1) // Solid
-			{
-				glm::vec2 pos(unit_width * x, unit_height * y);
-				glm::vec2 size(unit_width, unit_height);
-
-				GameObject obj(pos, size,
-					ResourceManager::GetTexture("block_solid"),
-					glm::vec3(0.8f, 0.8f, 0.7f));
-
-				obj.IsSolid = true;
-				this->Bricks.push_back(obj);
-			}
-			else if (tileData[y][x] > 1)
-			{
-				glm::vec3 color(1.f); // Original: White
-				if (tileData[y][x] == 2)
-					color = glm::vec3(0.2f, 0.6f, 1.0f);
-				if (tileData[y][x] == 3)
-					color = glm::vec3(0.0f, 0.7f, 0.0f);
-				if (tileData[y][x] == 4)
-					color = glm::vec3(0.8f, 0.8f, 0.4f);
-				if (tileData[y][x] == 5)
-					color = glm::vec3(1.0f, 0.5f, 0.0f);
-
-				glm::vec2 pos(unit_width * x, unit_height * y);
-				glm::vec2 size(unit_width, unit_height);
-				this->Bricks.push_back(
-					GameObject(pos, size, ResourceManager::GetTexture("block"), color)
-				);
-			}
+			unsigned int tileCode = tiles[y * width + x];
+			if (tileCode == 0)
+				continue;
+
+			glm::vec3 color(1.f); // Original: White
+			if (tileCode == 1) // Solid
+				color = glm::vec3(0.8f, 0.8f, 0.7f);
+			else if (tileCode == 2)
+				color = glm::vec3(0.2f, 0.6f, 1.0f);
+			else if (tileCode == 3)
+				color = glm::vec3(0.0f, 0.7f, 0.0f);
+			else if (tileCode == 4)
+				color = glm::vec3(0.8f, 0.8f, 0.4f);
+			else if (tileCode == 5)
+				color = glm::vec3(1.0f, 0.5f, 0.0f);
+
+			unsigned int brick = static_cast<unsigned int>(this->BrickPositions.size());
+			this->Cells[y * width + x] = static_cast<int>(brick);
+			this->BrickPositions.push_back(glm::vec2(unit_width * x, unit_height * y));
+			this->BrickColors.push_back(color);
+
+			if (tileCode == 1)
+				this->solid.Set(brick);
+			else
+				++this->remainingBricks;
 		}
 	}
+
+	this->breakableBricks = this->remainingBricks;
+}
+
+void GameLevel::clear()
+{
+	this->BrickPositions.clear();
+	this->BrickColors.clear();
+	this->Cells.clear();
+	this->Columns = this->Rows = 0;
+	this->solid.Resize(0);
+	this->destroyed.Resize(0);
+	this->remainingBricks = 0;
+	this->breakableBricks = 0;
 }
@@ -1,32 +1,80 @@
 #ifndef GAME_LEVEL_H
 #define GAME_LEVEL_H
 
+#include <cstdint>
 #include <vector>
 
-#include "GameObject.h"
-#include "SpriteRenderer.h"
+#include <glm/glm.hpp>
 
+#include "BitSet.h"
+
+// Bricks are stored as parallel arrays indexed by brick id. Collision code
+// only touches the hot data (positions and the solid/destroyed bitsets);
+// colors are only read by the renderer. Every brick fills exactly one grid
+// cell, so all of them share BrickSize.
 class GameLevel
 {
 public:
 	GameLevel() = default;
 
-	// Level state
-	std::vector<GameObject> Bricks;
+	// Brick state
+	std::vector<glm::vec2> BrickPositions;
+	std::vector<glm::vec3> BrickColors;
+	glm::vec2 BrickSize = glm::vec2(0.0f);
+
+	// Uniform grid the bricks were laid out on. Each cell holds the id of
+	// the brick occupying it, or EMPTY_CELL.
+	static const int EMPTY_CELL = -1;
+	unsigned int Columns = 0, Rows = 0;
+	float UnitWidth = 0.0f, UnitHeight = 0.0f;
+	std::vector<int> Cells;
+
+	// Loads level from file: a compiled .lvlb file is memory-mapped, anything
+	// else is parsed as .lvl text (see LevelFile.h). Returns false (leaving
+	// the level empty) if the file is missing or invalid
+	bool Load(const char *file, unsigned int levelWidth, unsigned int levelHeight);
 
-	// Loads level from file
-	void Load(const char *file, unsigned int levelWidth, unsigned int levelHeight);
+	// Loads level from columns * rows tile codes, row by row (e.g. a level
+	// embedded in the binary, see EmbeddedLevel.h)
+	void LoadTiles(const std::uint8_t *tiles, unsigned int columns, unsigned int rows,
+				   unsigned int levelWidth, unsigned int levelHeight);
 
-	// Render level
-	void Draw(SpriteRenderer &renderer);
+	// Restores the level as it was loaded (every brick intact). The layout
+	// is kept, so this only clears the destroyed flags
+	void Reset();
 
 	// Check if level is completed (all non-solid tiles are destroyed)
-	bool IsCompleted();
+	bool IsCompleted() const { return this->remainingBricks == 0; }
+
+	unsigned int BrickCount() const { return static_cast<unsigned int>(this->BrickPositions.size()); }
+	bool IsSolid(unsigned int brick) const { return this->solid.Test(brick); }
+	bool IsDestroyed(unsigned int brick) const { return this->destroyed.Test(brick); }
+
+	// Number of breakable bricks that are not destroyed yet
+	unsigned int RemainingBricks() const { return this->remainingBricks; }
+
+	// Marks a breakable brick as destroyed (solid bricks can't be destroyed)
+	void DestroyBrick(unsigned int brick);
+
+	// Destroyed flags of all bricks, one bit per brick id (for snapshots).
+	// RestoreDestroyedWords copies as many words as DestroyedWords holds from
+	// bytes, which need not be aligned
+	const std::vector<std::uint64_t> &DestroyedWords() const { return this->destroyed.Words; }
+	void RestoreDestroyedWords(const void *bytes);
+
+	// Appends to result the ids of all non-destroyed bricks overlapping the
+	// given circle (e.g. one bounding the ball's path for this tick). Only the
+	// grid cells under the circle are visited and the bricks in each row are
+	// tested in SIMD batches, so cost doesn't grow with the level's brick count
+	void QueryBricks(glm::vec2 center, float radius, std::vector<unsigned int> &result) const;
 
 private:
-	// Initialize level from tile data
-	void Init(std::vector<std::vector<unsigned int>> tileData,
-			  unsigned int levelWidth, unsigned int levelHeight);
+	BitSet solid;
+	BitSet destroyed;
+	unsigned int remainingBricks = 0;
+	unsigned int breakableBricks = 0;
+
+	void clear();
 };
 
 #endif // !GAME_LEVEL_H
@@ -2,19 +2,30 @@
 
 GameObject::GameObject()
 	: Position(0.0f), Size(1.0f), Velocity(0.0f), Color(1.0f), Rotation(0.0f),
-	Sprite(), IsSolid(false), Destroyed(false)
+	IsSolid(false), Destroyed(false)
 {
 }
 
-GameObject::GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color, glm::vec2 velocity)
+GameObject::GameObject(glm::vec2 pos, glm::vec2 size, glm::vec3 color, glm::vec2 velocity)
 	: Position(pos), Size(size), Velocity(velocity), Color(color), Rotation(0.0f), 
-	Sprite(sprite), IsSolid(false), Destroyed(false)
+	IsSolid(false), Destroyed(false)
 {
 }
 
-void GameObject::Draw(SpriteRenderer &renderer)
+
+void GameObject::Save(ByteWriter &out) const
 {
-	renderer.DrawSprite(this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
+	out.Put(this->Position);
+	out.Put(this->Size);
+	out.Put(this->Velocity);
+	out.Put(this->Color);
+	out.Put(this->Rotation);
+	out.Put(this->IsSolid);
+	out.Put(this->Destroyed);
 }
 
-
+bool GameObject::Restore(ByteReader &in)
+{
+	return in.Get(this->Position) && in.Get(this->Size) && in.Get(this->Velocity) && in.Get(this->Color)
+		&& in.Get(this->Rotation) && in.Get(this->IsSolid) && in.Get(this->Destroyed);
+}
@@ -2,14 +2,16 @@
 #define GAME_OBJECT_H
 
 #include <glm/glm.hpp>
-#include "Texture.h"
-#include "SpriteRenderer.h"
 
+#include "ByteStream.h"
+
+// Gameplay state of a single entity. It holds no render resources, so it
+// can be simulated without an OpenGL context; the renderer picks the sprite.
 class GameObject
 {
 public:
 	GameObject();
-	GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
+	GameObject(glm::vec2 pos, glm::vec2 size, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
 
 	// Object state
 	glm::vec2 Position, Size, Velocity;
@@ -18,11 +20,9 @@ public:
 	bool IsSolid;
 	bool Destroyed;
 
-	// Render state
-	Texture2D Sprite;
-
-	// Draw sprite
-	virtual void Draw(SpriteRenderer &renderer);
+	// Field by field binary copy of the state (no padding, so the bytes can be hashed)
+	void Save(ByteWriter &out) const;
+	bool Restore(ByteReader &in);
 };
 
 #endif // !GAME_OBJECT_H
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "GameLevel.h"
+#include "LevelFile.h"
+#include "LevelGenerator.h"
+
+// Level compiler (level_compiler target). Converts text levels to the
+// memory-mapped binary format (see LevelFile.h):
+//
+//     level_compiler file.lvl...
+//
+// writes file.lvlb next to every input, after checking that all rows are
+// the same width and every tile code is known.
+//
+//     level_compiler --check file...
+//
+// validates .lvl or .lvlb files without writing anything, and reports the
+// size of each level and how long GameLevel::Load takes for it.
+//
+//     level_compiler --generate output columns rows [--pattern name] [--density d] [--solid s] [--seed seed]
+//
+// writes a procedurally generated level for stress tests and benchmarks (see
+// LevelGenerator.h for the patterns: random, walls, checkerboard, tunnels),
+// as .lvlb if output ends in .lvlb and as .lvl text otherwise. Play it with
+// breakout_sim --level output.
+
+const unsigned int LEVEL_WIDTH = 800;
+const unsigned int LEVEL_HEIGHT = 300;
+
+bool EndsWith(const std::string &text, const char *suffix)
+{
+	std::size_t length = std::strlen(suffix);
+	return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+bool Compile(const char *file)
+{
+	std::ifstream stream(file, std::ios::binary);
+	if (!stream)
+	{
+		std::cout << "ERROR::LEVEL: Failed to open level file " << file << std::endl;
+		return false;
+	}
+	std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	std::vector<std::uint8_t> tiles;
+	unsigned int columns, rows;
+	std::string error;
+	if (!ParseLevelText(text.data(), text.size(), tiles, columns, rows, error))
+	{
+		std::cout << "ERROR::LEVEL: " << file << ": " << error << std::endl;
+		return false;
+	}
+
+	std::string output = file;
+	if (EndsWith(output, ".lvl"))
+		output.erase(output.size() - 4);
+	output += ".lvlb";
+
+	if (!WriteLevelBinary(output.c_str(), tiles.data(), columns, rows))
+		return false;
+	std::cout << file << " -> " << output << " (" << columns << "x" << rows << ")" << std::endl;
+	return true;
+}
+
+bool Check(const char *file)
+{
+	auto start = std::chrono::steady_clock::now();
+	GameLevel level;
+	if (!level.Load(file, LEVEL_WIDTH, LEVEL_HEIGHT))
+		return false;
+	auto end = std::chrono::steady_clock::now();
+
+	std::cout << file << ": " << level.Columns << "x" << level.Rows << ", "
+		<< level.BrickCount() << " bricks (" << level.RemainingBricks() << " breakable), loaded in "
+		<< std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+	return true;
+}
+
+int Generate(int argc, char *argv[])
+{
+	LevelGeneratorSettings settings;
+	const char *output = argc > 2 ? argv[2] : nullptr;
+	int columns = argc > 3 ? std::atoi(argv[3]) : 0;
+	int rows = argc > 4 ? std::atoi(argv[4]) : 0;
+	bool valid = output && columns > 0 && rows > 0;
+	for (int i = 5; i < argc && valid; ++i)
+	{
+		if (std::strcmp(argv[i], "--pattern") == 0 && i + 1 < argc)
+			valid = ParseLevelPattern(argv[++i], settings.Pattern);
+		else if (std::strcmp(argv[i], "--density") == 0 && i + 1 < argc)
+			settings.Density = static_cast<float>(std::atof(argv[++i]));
+		else if (std::strcmp(argv[i], "--solid") == 0 && i + 1 < argc)
+			settings.SolidFraction = static_cast<float>(std::atof(argv[++i]));
+		else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			settings.Seed = std::strtoull(argv[++i], nullptr, 0);
+		else
+			valid = false;
+	}
+	if (!valid)
+	{
+		std::cout << "Usage: level_compiler --generate output columns rows [--pattern random|walls|checkerboard|tunnels]" << std::endl;
+		std::cout << "                      [--density fraction] [--solid fraction] [--seed seed]" << std::endl;
+		return -1;
+	}
+	settings.Columns = static_cast<unsigned int>(columns);
+	settings.Rows = static_cast<unsigned int>(rows);
+
+	std::vector<std::uint8_t> tiles;
+	GenerateLevel(settings, tiles);
+
+	bool binary = EndsWith(output, ".lvlb");
+	if (!(binary ? WriteLevelBinary : WriteLevelText)(output, tiles.data(), settings.Columns, settings.Rows))
+		return 1;
+
+	std::size_t bricks = tiles.size() - std::count(tiles.begin(), tiles.end(), 0);
+	std::size_t solid = std::count(tiles.begin(), tiles.end(), 1);
+	std::cout << output << ": " << columns << "x" << rows << " " << LevelPatternName(settings.Pattern)
+		<< ", " << bricks << " bricks (" << bricks - solid << " breakable)" << std::endl;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "--generate") == 0)
+		return Generate(argc, argv);
+
+	bool check = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+	int first = check ? 2 : 1;
+	if (first >= argc)
+	{
+		std::cout << "Usage: level_compiler file.lvl..." << std::endl;
+		std::cout << "       level_compiler --check file..." << std::endl;
+		std::cout << "       level_compiler --generate output columns rows [options]" << std::endl;
+		return -1;
+	}
+
+	int failed = 0;
+	for (int i = first; i < argc; ++i)
+		if (!(check ? Check(argv[i]) : Compile(argv[i])))
+			++failed;
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+#include "LevelFile.h"
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char LEVEL_BINARY_MAGIC[4] = { 'L', 'V', 'L', 'B' };
+
+static bool IsSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool ParseLevelText(const char *text, std::size_t size, std::vector<std::uint8_t> &tiles,
+					unsigned int &columns, unsigned int &rows, std::string &error)
+{
+	tiles.clear();
+	columns = rows = 0;
+
+	const char *end = text + size;
+	unsigned int lineNumber = 0;
+	for (const char *line = text; line < end; )
+	{
+		const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', end - line));
+		if (!lineEnd)
+			lineEnd = end;
+		++lineNumber;
+
+		unsigned int count = 0;
+		for (const char *p = line; ; )
+		{
+			while (p < lineEnd && IsSpace(*p))
+				++p;
+			if (p == lineEnd)
+				break;
+
+			unsigned int tileCode;
+			std::from_chars_result result = std::from_chars(p, lineEnd, tileCode);
+			if (result.ec != std::errc() || (result.ptr < lineEnd && !IsSpace(*result.ptr)))
+			{
+				error = "line " + std::to_string(lineNumber) + ": expected a tile code";
+				return false;
+			}
+			if (tileCode > MAX_TILE_CODE)
+			{
+				error = "line " + std::to_string(lineNumber) + ": unknown tile code " + std::to_string(tileCode);
+				return false;
+			}
+			tiles.push_back(static_cast<std::uint8_t>(tileCode));
+			++count;
+			p = result.ptr;
+		}
+
+		line = lineEnd + 1;
+		if (count == 0)
+			continue;
+		if (rows > 0 && count != columns)
+		{
+			error = "line " + std::to_string(lineNumber) + ": " + std::to_string(count)
+				+ " tiles, but the level is " + std::to_string(columns) + " wide";
+			return false;
+		}
+		columns = count;
+		++rows;
+	}
+
+	if (rows == 0)
+	{
+		error = "no tiles";
+		return false;
+	}
+	return true;
+}
+
+const std::uint8_t *ReadLevelBinary(const std::uint8_t *data, std::size_t size,
+									unsigned int &columns, unsigned int &rows, std::string &error)
+{
+	LevelBinaryHeader header;
+	if (size < sizeof(header))
+	{
+		error = "truncated header";
+		return nullptr;
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	if (std::memcmp(header.Magic, LEVEL_BINARY_MAGIC, sizeof(header.Magic)) != 0)
+	{
+		error = "not a compiled level";
+		return nullptr;
+	}
+	if (header.Version != LEVEL_BINARY_VERSION)
+	{
+		error = "version " + std::to_string(header.Version) + ", expected " + std::to_string(LEVEL_BINARY_VERSION);
+		return nullptr;
+	}
+	std::uint64_t tileCount = static_cast<std::uint64_t>(header.Columns) * header.Rows;
+	if (tileCount == 0 || tileCount != size - sizeof(header))
+	{
+		error = "size doesn't match " + std::to_string(header.Columns) + "x" + std::to_string(header.Rows) + " tiles";
+		return nullptr;
+	}
+
+	const std::uint8_t *tiles = data + sizeof(header);
+	for (std::size_t i = 0; i < tileCount; ++i)
+	{
+		if (tiles[i] > MAX_TILE_CODE)
+		{
+			error = "unknown tile code " + std::to_string(tiles[i]) + " at tile " + std::to_string(i);
+			return nullptr;
+		}
+	}
+
+	columns = header.Columns;
+	rows = header.Rows;
+	return tiles;
+}
+
+bool WriteLevelText(const char *file, const std::uint8_t *tiles, unsigned int columns, unsigned int rows)
+{
+	// Every code is a single digit, so each row is exactly columns * 2 bytes
+	std::string row(static_cast<std::size_t>(columns) * 2, ' ');
+	row.back() = '\n';
+
+	std::ofstream stream(file, std::ios::binary);
+	for (unsigned int y = 0; y < rows && stream; ++y)
+	{
+		for (unsigned int x = 0; x < columns; ++x)
+			row[x * 2] = static_cast<char>('0' + tiles[static_cast<std::size_t>(y) * columns + x]);
+		stream.write(row.data(), row.size());
+	}
+	if (!stream)
+	{
+		std::cout << "ERROR::LEVEL: Failed to write level file " << file << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool WriteLevelBinary(const char *file, const std::uint8_t *tiles, unsigned int columns, unsigned int rows)
+{
+	LevelBinaryHeader header;
+	std::memcpy(header.Magic, LEVEL_BINARY_MAGIC, sizeof(header.Magic));
+	header.Version = LEVEL_BINARY_VERSION;
+	header.Columns = columns;
+	header.Rows = rows;
+
+	std::ofstream stream(file, std::ios::binary);
+	stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char *>(tiles), static_cast<std::streamsize>(columns) * rows);
+	if (!stream)
+	{
+		std::cout << "ERROR::LEVEL: Failed to write level file " << file << std::endl;
+		return false;
+	}
+	return true;
+}
+
+MappedFile::~MappedFile()
+{
+	this->Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char *file)
+{
+	this->Close();
+
+	HANDLE handle = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+	this->file = handle;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0)
+	{
+		this->Close();
+		return false;
+	}
+
+	this->mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (this->mapping)
+		this->data = static_cast<const std::uint8_t *>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!this->data)
+	{
+		this->Close();
+		return false;
+	}
+	this->size = static_cast<std::size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (this->data)
+		UnmapViewOfFile(this->data);
+	if (this->mapping)
+		CloseHandle(this->mapping);
+	if (this->file)
+		CloseHandle(this->file);
+	this->data = nullptr;
+	this->mapping = this->file = nullptr;
+	this->size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const char *file)
+{
+	this->Close();
+
+	int descriptor = open(file, O_RDONLY);
+	if (descriptor < 0)
+		return false;
+
+	struct stat status;
+	void *data = MAP_FAILED;
+	if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+		data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+	// The mapping stays valid after the descriptor is closed
+	close(descriptor);
+	if (data == MAP_FAILED)
+		return false;
+
+	this->data = static_cast<const std::uint8_t *>(data);
+	this->size = static_cast<std::size_t>(status.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (this->data)
+		munmap(const_cast<std::uint8_t *>(this->data), this->size);
+	this->data = nullptr;
+	this->size = 0;
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Level files come in two flavours:
+//
+//   .lvl    text, one line per row of whitespace-separated tile codes
+//           (0 empty, 1 solid, 2-5 breakable colors). Hand-edited.
+//   .lvlb   compiled with level_compiler and loaded by memory-mapping it,
+//           so loading does no parsing at all. Native byte order:
+//               char[4]  "LVLB"
+//               uint32   version
+//               uint32   columns, rows
+//               uint8    tile codes, row by row
+struct LevelBinaryHeader
+{
+	char Magic[4];
+	std::uint32_t Version;
+	std::uint32_t Columns;
+	std::uint32_t Rows;
+};
+
+const std::uint32_t LEVEL_BINARY_VERSION = 1;
+const unsigned int MAX_TILE_CODE = 5;
+
+// Parses a .lvl file's contents into tiles (columns * rows codes, row by
+// row). Blank lines are skipped; every other line must have the same number
+// of valid tile codes. On failure returns false and describes the problem in
+// error
+bool ParseLevelText(const char *text, std::size_t size, std::vector<std::uint8_t> &tiles,
+					unsigned int &columns, unsigned int &rows, std::string &error);
+
+// Checks a .lvlb file's contents. On success returns its tile codes (which
+// point into data) and dimensions, otherwise returns nullptr and describes
+// the problem in error
+const std::uint8_t *ReadLevelBinary(const std::uint8_t *data, std::size_t size,
+									unsigned int &columns, unsigned int &rows, std::string &error);
+
+// Writes tiles as .lvl text
+bool WriteLevelText(const char *file, const std::uint8_t *tiles, unsigned int columns, unsigned int rows);
+
+bool WriteLevelBinary(const char *file, const std::uint8_t *tiles, unsigned int columns, unsigned int rows);
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	bool Open(const char *file);
+	void Close();
+
+	const std::uint8_t *Data() const { return this->data; }
+	std::size_t Size() const { return this->size; }
+
+private:
+	const std::uint8_t *data = nullptr;
+	std::size_t size = 0;
+#ifdef _WIN32
+	void *file = nullptr;
+	void *mapping = nullptr;
+#endif
+};
+
+#endif // !LEVEL_FILE_H
@@ -0,0 +1,107 @@
+#include "LevelGenerator.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const char *const LEVEL_PATTERN_NAMES[LEVEL_PATTERN_COUNT] = {
+	"random", "walls", "checkerboard", "tunnels"
+};
+
+// A breakable brick with a random color, or nothing
+static std::uint8_t BreakableTile(Random &random, float density)
+{
+	if (random.Float() >= density)
+		return 0;
+	return static_cast<std::uint8_t>(2 + random.Below(4));
+}
+
+// A solid or breakable brick, or nothing
+static std::uint8_t AnyTile(Random &random, float density, float solidFraction)
+{
+	if (random.Float() >= density)
+		return 0;
+	return random.Float() < solidFraction ? 1 : static_cast<std::uint8_t>(2 + random.Below(4));
+}
+
+// Columns between the starts of two walls so that walls take up about
+// fraction of the level
+static unsigned int WallSpacing(float fraction)
+{
+	if (fraction <= 0.0f)
+		return 0;
+	return std::max(2u, static_cast<unsigned int>(1.0f / fraction + 0.5f));
+}
+
+void GenerateLevel(const LevelGeneratorSettings &settings, std::vector<std::uint8_t> &tiles)
+{
+	unsigned int columns = settings.Columns, rows = settings.Rows;
+	float density = std::min(std::max(settings.Density, 0.0f), 1.0f);
+	float solidFraction = std::min(std::max(settings.SolidFraction, 0.0f), 1.0f);
+
+	Random random(settings.Seed);
+	tiles.assign(static_cast<std::size_t>(columns) * rows, 0);
+
+	switch (settings.Pattern)
+	{
+	case LEVEL_PATTERN_WALLS:
+	{
+		unsigned int spacing = WallSpacing(solidFraction);
+		for (unsigned int y = 0; y < rows; ++y)
+			for (unsigned int x = 0; x < columns; ++x)
+				tiles[y * columns + x] = spacing && x % spacing == spacing / 2 ? 1 : BreakableTile(random, density);
+		break;
+	}
+	case LEVEL_PATTERN_CHECKERBOARD:
+		for (unsigned int y = 0; y < rows; ++y)
+			for (unsigned int x = 0; x < columns; ++x)
+				if ((x + y) % 2 == 0)
+					tiles[y * columns + x] = AnyTile(random, density, solidFraction);
+		break;
+	case LEVEL_PATTERN_TUNNELS:
+	{
+		// Start from solid rock and let each tunnel wander sideways one
+		// tile at a time as it goes down. Tunnels are lined with breakable
+		// bricks (as dense as density), so balls get stuck bouncing inside
+		std::fill(tiles.begin(), tiles.end(), 1);
+		unsigned int spacing = WallSpacing(1.0f - solidFraction);
+		if (spacing == 0)
+			break;
+		for (unsigned int start = spacing / 2; start < columns; start += spacing)
+		{
+			unsigned int x = start;
+			for (unsigned int y = 0; y < rows; ++y)
+			{
+				tiles[y * columns + x] = BreakableTile(random, density);
+				unsigned int step = random.Below(3);
+				if (step == 0 && x > 0)
+					tiles[y * columns + --x] = BreakableTile(random, density);
+				else if (step == 2 && x + 1 < columns)
+					tiles[y * columns + ++x] = BreakableTile(random, density);
+			}
+		}
+		break;
+	}
+	default:
+		for (std::uint8_t &tile : tiles)
+			tile = AnyTile(random, density, solidFraction);
+		break;
+	}
+}
+
+const char *LevelPatternName(LevelPattern pattern)
+{
+	return pattern < LEVEL_PATTERN_COUNT ? LEVEL_PATTERN_NAMES[pattern] : "unknown";
+}
+
+bool ParseLevelPattern(const char *name, LevelPattern &pattern)
+{
+	for (int i = 0; i < LEVEL_PATTERN_COUNT; ++i)
+	{
+		if (std::strcmp(name, LEVEL_PATTERN_NAMES[i]) == 0)
+		{
+			pattern = static_cast<LevelPattern>(i);
+			return true;
+		}
+	}
+	return false;
+}
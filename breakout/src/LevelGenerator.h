@@ -0,0 +1,40 @@
+#ifndef LEVEL_GENERATOR_H
+#define LEVEL_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Random.h"
+
+// Layouts the generator can produce. Each stresses a different worst case
+// of the brick collision code
+enum LevelPattern {
+	LEVEL_PATTERN_RANDOM,		// bricks scattered uniformly
+	LEVEL_PATTERN_WALLS,		// full-height solid walls, breakable bricks between them
+	LEVEL_PATTERN_CHECKERBOARD,	// alternating bricks and gaps, the most brick edges per area
+	LEVEL_PATTERN_TUNNELS,		// solid mass cut by winding one tile wide tunnels
+	LEVEL_PATTERN_COUNT
+};
+
+struct LevelGeneratorSettings
+{
+	unsigned int Columns = 15;
+	unsigned int Rows = 8;
+	LevelPattern Pattern = LEVEL_PATTERN_RANDOM;
+	// Fraction of the tiles the pattern leaves open that get a brick
+	float Density = 1.0f;
+	// Fraction of bricks that are solid. Walls and tunnels use it for the
+	// share of the level taken up by walls
+	float SolidFraction = 0.1f;
+	std::uint64_t Seed = Random::DEFAULT_SEED;
+};
+
+// Fills tiles with Columns * Rows tile codes, row by row, in the .lvl
+// encoding (see LevelFile.h). The same settings always give the same level
+void GenerateLevel(const LevelGeneratorSettings &settings, std::vector<std::uint8_t> &tiles);
+
+// Pattern names as used on the command line ("random", "walls", ...)
+const char *LevelPatternName(LevelPattern pattern);
+bool ParseLevelPattern(const char *name, LevelPattern &pattern);
+
+#endif // !LEVEL_GENERATOR_H
@@ -0,0 +1,194 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <glm/ext/matrix_clip_space.hpp>
+
+#include "EmbeddedShaders.h"
+#include "FrameUniforms.h"
+#include "GLState.h"
+#include "ParticleGenerator.h"
+
+// Headless check of the GPU particle path (particle_check target):
+//
+//     particle_check
+//
+// Opens a hidden window with the game's GL 3.3 core context, then plays the
+// same scripted emitters once through the CPU ParticlePool path and once
+// through ParticleFeedback, drawing both into an offscreen framebuffer. The
+// two images must match; exits non-zero when they don't, when transform
+// feedback is unavailable or on a GL error. Needs nothing the game doesn't,
+// so it runs on Mesa's software rasterizers (softpipe, llvmpipe) in CI.
+
+const unsigned int WIDTH = 800;
+const unsigned int HEIGHT = 600;
+
+// Simulated ticks, and how many of them pass between two draws
+const unsigned int TICKS = 240;
+const unsigned int DRAW_INTERVAL = 4;
+const float TICK_TIME = 1.0f / 240.0f;
+
+// Channel values may differ by this much, e.g. from fused multiply-adds on
+// one side only, and this fraction of channels may differ by more (a
+// particle that lands a pixel over on one side)
+const int CHANNEL_TOLERANCE = 2;
+const double MAX_DIFFERING_FRACTION = 0.001;
+
+// Plays the emitter script and returns the final frame as RGBA pixels, or
+// nothing if the GPU path was asked for but couldn't be set up
+std::vector<unsigned char> Run(Shader &shader, Texture2D &texture, bool gpu)
+{
+	ParticleGenerator particles(shader, texture, 10000);
+	if (gpu && !particles.UseTransformFeedback())
+		return std::vector<unsigned char>();
+
+	// A ball-like trail along a wave and a burst every 40 ticks
+	ParticleEmitter trail;
+	trail.Rate = 480.0f;
+	trail.VelocityScale = -0.1f;
+	ParticleEmitter burst;
+	burst.Life = 0.6f;
+	burst.Speed = 150.0f;
+	burst.Jitter = 10.0f;
+
+	for (unsigned int tick = 0; tick < TICKS; ++tick)
+	{
+		float t = tick / static_cast<float>(TICKS);
+		particles.Pool.Emit(trail, TICK_TIME, glm::vec2(100.0f + 600.0f * t, 300.0f + 100.0f * std::sin(6.0f * t)), glm::vec2(600.0f, 0.0f));
+		if (tick % 40 == 0)
+			particles.Pool.Burst(burst, 24, glm::vec2(400.0f, 150.0f), glm::vec2(0.0f), glm::vec3(1.0f, 0.5f, 0.2f));
+		particles.Update(TICK_TIME);
+
+		// Draws in between keep the GPU path's buffer rotation honest
+		if (tick % DRAW_INTERVAL == 0)
+		{
+			glClear(GL_COLOR_BUFFER_BIT);
+			particles.Draw();
+		}
+	}
+
+	glClear(GL_COLOR_BUFFER_BIT);
+	particles.Draw();
+	std::vector<unsigned char> pixels(WIDTH * HEIGHT * 4);
+	glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+int main()
+{
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+#ifdef _APPLE_
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+	glfwWindowHint(GLFW_VISIBLE, false);
+
+	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "particle_check", nullptr, nullptr);
+	if (!window)
+	{
+		std::cout << "ERROR::PARTICLE_CHECK: Failed to create a GL 3.3 core context" << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// GLAD: Load all OpenGL function pointers
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		std::cout << "Failed to initialzie GLAD" << std::endl;
+		return -1;
+	}
+	std::cout << "renderer:         " << glGetString(GL_RENDERER) << ", " << glGetString(GL_VERSION) << std::endl;
+
+	int result = 0;
+	{
+		// Draw offscreen; the default framebuffer of a hidden window may not
+		// keep its pixels
+		unsigned int FBO, RBO;
+		glGenFramebuffers(1, &FBO);
+		glGenRenderbuffers(1, &RBO);
+		GLState::BindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glBindRenderbuffer(GL_RENDERBUFFER, RBO);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, RBO);
+		glViewport(0, 0, WIDTH, HEIGHT);
+		glEnable(GL_BLEND);
+
+		FrameUniforms frameUniforms;
+		frameUniforms.Data.Projection = glm::ortho(0.0f, static_cast<float>(WIDTH), static_cast<float>(HEIGHT), 0.0f, -1.0f, 1.0f);
+		frameUniforms.Upload();
+
+		Shader shader;
+		shader.Compile(PARTICLE_VERT, PARTICLE_FRAG);
+		shader.Use().SetInteger("sprite", 0);
+
+		// Round, soft-edged sprite, so texture sampling takes part as well
+		const unsigned int SPRITE_SIZE = 16;
+		std::vector<unsigned char> sprite(SPRITE_SIZE * SPRITE_SIZE * 4, 255);
+		for (unsigned int y = 0; y < SPRITE_SIZE; ++y)
+			for (unsigned int x = 0; x < SPRITE_SIZE; ++x)
+			{
+				glm::vec2 offset = (glm::vec2(x, y) + 0.5f) / (SPRITE_SIZE / 2.0f) - 1.0f;
+				sprite[(y * SPRITE_SIZE + x) * 4 + 3] = static_cast<unsigned char>(255.0f * glm::clamp(1.0f - glm::length(offset), 0.0f, 1.0f));
+			}
+		Texture2D texture;
+		texture.Internal_Format = GL_RGBA;
+		texture.Image_Format = GL_RGBA;
+		texture.Generate(SPRITE_SIZE, SPRITE_SIZE, sprite.data());
+
+		std::vector<unsigned char> cpu = Run(shader, texture, false);
+		std::vector<unsigned char> gpu = Run(shader, texture, true);
+
+		std::size_t differing = 0;
+		unsigned long long brightness = 0;
+		for (std::size_t i = 0; i < gpu.size(); ++i)
+		{
+			if (std::abs(cpu[i] - gpu[i]) > CHANNEL_TOLERANCE)
+				++differing;
+			brightness += gpu[i];
+		}
+		unsigned int error = glGetError();
+
+		if (gpu.empty())
+		{
+			std::cout << "ERROR::PARTICLE_CHECK: Transform feedback is unavailable" << std::endl;
+			result = 1;
+		}
+		else
+		{
+			std::cout << "differing values: " << differing << " of " << gpu.size() << std::endl;
+			if (brightness == 0)
+			{
+				std::cout << "ERROR::PARTICLE_CHECK: The GPU path drew nothing" << std::endl;
+				result = 1;
+			}
+			else if (differing > MAX_DIFFERING_FRACTION * gpu.size())
+			{
+				std::cout << "ERROR::PARTICLE_CHECK: CPU and GPU particles differ" << std::endl;
+				result = 1;
+			}
+		}
+		if (error != GL_NO_ERROR)
+		{
+			std::cout << "ERROR::PARTICLE_CHECK: GL error 0x" << std::hex << error << std::dec << std::endl;
+			result = 1;
+		}
+		if (result == 0)
+			std::cout << "CPU and GPU particles match" << std::endl;
+
+		GLState::DeleteTextures(1, &texture.ID);
+		GLState::DeleteProgram(shader.ID);
+		GLState::DeleteFramebuffers(1, &FBO);
+		glDeleteRenderbuffers(1, &RBO);
+	}
+
+	glfwTerminate();
+	return result;
+}
@@ -0,0 +1,146 @@
+#include "ParticleFeedback.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "EmbeddedShaders.h"
+#include "GLState.h"
+
+// Outputs of particle_update.vert, in FeedbackParticle order
+static const char *const FEEDBACK_VARYINGS[] = { "outPosition", "outVelocity", "outColor", "outFade", "outScale" };
+
+ParticleFeedback::ParticleFeedback(Shader &drawShader, Texture2D &texture, unsigned int capacity)
+	: drawShader(drawShader), texture(texture), capacity(std::max(capacity, 1u))
+{
+	this->valid = this->updateShader.CompileFeedback(PARTICLE_UPDATE_VERT, FEEDBACK_VARYINGS,
+		static_cast<int>(sizeof(FEEDBACK_VARYINGS) / sizeof(FEEDBACK_VARYINGS[0])));
+	this->dtLocation = this->updateShader.Uniform("dt");
+	this->initRenderData();
+}
+
+ParticleFeedback::~ParticleFeedback()
+{
+	GLState::DeleteVertexArrays(2, this->updateVAOs);
+	GLState::DeleteVertexArrays(2, this->drawVAOs);
+	glDeleteBuffers(2, this->buffers);
+	glDeleteBuffers(1, &this->quadVBO);
+	GLState::DeleteProgram(this->updateShader.ID);
+}
+
+void ParticleFeedback::Inject(ParticlePool &pool)
+{
+	unsigned int count = pool.Count();
+	if (count == 0)
+		return;
+
+	// More new particles than slots: only the newest ones survive anyway
+	unsigned int first = count > this->capacity ? count - this->capacity : 0;
+	this->staging.resize(count - first);
+	for (unsigned int i = first; i < count; ++i)
+		this->staging[i - first] = { glm::vec2(pool.PositionX[i], pool.PositionY[i]), glm::vec2(pool.VelocityX[i], pool.VelocityY[i]),
+			glm::vec4(pool.Colors[i], pool.Alpha(i)), pool.Fade[i], pool.Scales[i] };
+	pool.Clear();
+
+	// Write over the oldest slots, wrapping around at the end of the buffer
+	glBindBuffer(GL_ARRAY_BUFFER, this->buffers[this->current]);
+	std::size_t written = 0;
+	while (written < this->staging.size())
+	{
+		std::size_t run = std::min<std::size_t>(this->staging.size() - written, this->capacity - this->cursor);
+		glBufferSubData(GL_ARRAY_BUFFER, this->cursor * sizeof(FeedbackParticle), run * sizeof(FeedbackParticle),
+			&this->staging[written]);
+		written += run;
+		this->cursor = static_cast<unsigned int>((this->cursor + run) % this->capacity);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleFeedback::Update(float dt)
+{
+	unsigned int next = 1 - this->current;
+
+	this->updateShader.Use();
+	this->updateShader.SetFloat(this->dtLocation, dt);
+
+	glEnable(GL_RASTERIZER_DISCARD);
+	GLState::BindVertexArray(this->updateVAOs[this->current]);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->buffers[next]);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, this->capacity);
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	this->current = next;
+}
+
+void ParticleFeedback::Draw()
+{
+	// Every slot is drawn; particle.vert collapses the dead ones
+	this->drawShader.Use();
+	this->texture.Bind();
+	GLState::BindVertexArray(this->drawVAOs[this->current]);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, this->capacity);
+}
+
+void ParticleFeedback::initRenderData()
+{
+	// Same quad as ParticleGenerator
+	float particle_quad[] = {
+		0.0f, 1.0f, 0.0f, 1.0f,
+		1.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f,
+
+		0.0f, 1.0f, 0.0f, 1.0f,
+		1.0f, 1.0f, 1.0f, 1.0f,
+		1.0f, 0.0f, 1.0f, 0.0f
+	};
+
+	glGenBuffers(1, &this->quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(particle_quad), particle_quad, GL_STATIC_DRAW);
+
+	// All slots start out dead (alpha 0)
+	std::vector<FeedbackParticle> empty(this->capacity, FeedbackParticle{});
+	glGenBuffers(2, this->buffers);
+	glGenVertexArrays(2, this->updateVAOs);
+	glGenVertexArrays(2, this->drawVAOs);
+	for (int i = 0; i < 2; ++i)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, this->buffers[i]);
+		glBufferData(GL_ARRAY_BUFFER, empty.size() * sizeof(FeedbackParticle), empty.data(), GL_DYNAMIC_COPY);
+
+		// Update pass: one vertex per particle, locations as in particle_update.vert
+		GLState::BindVertexArray(this->updateVAOs[i]);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Position));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Velocity));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Color));
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Fade));
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Scale));
+
+		// Drawing: the quad, plus one instance per particle as in particle.vert
+		GLState::BindVertexArray(this->drawVAOs[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
+		glBindBuffer(GL_ARRAY_BUFFER, this->buffers[i]);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Position));
+		glVertexAttribDivisor(1, 1);
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Color));
+		glVertexAttribDivisor(2, 1);
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(FeedbackParticle), (void *)offsetof(FeedbackParticle, Scale));
+		glVertexAttribDivisor(3, 1);
+	}
+	GLState::BindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,66 @@
+#ifndef PARTICLE_FEEDBACK_H
+#define PARTICLE_FEEDBACK_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ParticlePool.h"
+#include "Shader.h"
+#include "Texture.h"
+
+// State of one particle in the GPU particle path, as read and written by
+// particle_update.vert
+struct FeedbackParticle
+{
+	glm::vec2 Position;
+	glm::vec2 Velocity;
+	glm::vec4 Color;	// alpha 0: dead
+	float Fade;
+	float Scale;
+};
+
+// GPU particle path (see ParticleGenerator::UseTransformFeedback). Particle
+// state lives in two GL buffers; every Update runs particle_update.vert
+// over one of them and captures the result into the other with transform
+// feedback, so nothing but new particles crosses the bus. New particles are
+// taken from a ParticlePool, which the emitters spawn into as usual, and
+// written over the oldest slots with one or two glBufferSubData calls.
+// Needs nothing beyond GL 3.3, so it runs on Mesa's softpipe.
+class ParticleFeedback
+{
+public:
+	// drawShader: the particle shader, which reads this state as instance attributes
+	ParticleFeedback(Shader &drawShader, Texture2D &texture, unsigned int capacity);
+	~ParticleFeedback();
+
+	// False if the update program failed to build; don't use it then
+	bool Valid() const { return this->valid; }
+
+	// Moves the particles spawned into pool to the GPU and empties it
+	void Inject(ParticlePool &pool);
+
+	void Update(float dt);
+	void Draw();
+
+private:
+	Shader updateShader, drawShader;
+	int dtLocation;
+	Texture2D texture;
+	unsigned int capacity;
+	bool valid;
+
+	// State buffers, the VAO reading each for the update pass and for drawing,
+	// and which buffer holds the current state
+	unsigned int buffers[2], updateVAOs[2], drawVAOs[2];
+	unsigned int quadVBO;
+	unsigned int current = 0;
+
+	// Next slot injected particles are written to; slots are reused in order
+	unsigned int cursor = 0;
+	std::vector<FeedbackParticle> staging;
+
+	void initRenderData();
+};
+
+#endif // !PARTICLE_FEEDBACK_H
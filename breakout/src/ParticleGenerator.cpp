@@ -1,63 +1,124 @@
 #include "ParticleGenerator.h"
 #include <glad/glad.h>
+#include <cstddef>
+#include "GLState.h"
 
-ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount)
-	: shader(shader), texture(texture), amount(amount)
+ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, std::uint64_t seed)
+	: Pool(amount, seed), amount(amount), shader(shader), texture(texture)
 {
 	this->Init();
 }
 
-void ParticleGenerator::Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset)
+ParticleGenerator::~ParticleGenerator()
 {
-	// Add new particles
-	for (size_t i = 0; i < newParticles; ++i)
+	delete this->feedback;
+
+	for (void *fence : this->fences)
+		if (fence)
+			glDeleteSync(static_cast<GLsync>(fence));
+
+	glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+	if (this->mappedInstances)
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glDeleteBuffers(1, &this->instanceVBO);
+	GLState::DeleteVertexArrays(1, &this->VAO);
+}
+
+bool ParticleGenerator::UseTransformFeedback()
+{
+	if (this->feedback)
+		return true;
+
+	ParticleFeedback *feedback = new ParticleFeedback(this->shader, this->texture, this->amount);
+	if (!feedback->Valid())
 	{
-		int unusedParticle = this->FirstUnusedParticle();
-		this->RespawnParticle(this->particles[unusedParticle], object, offset);
+		delete feedback;
+		return false;
 	}
 
-	// Update all particles
-	for (size_t i = 0; i < this->amount; ++i)
+	// Particles already on the CPU carry over as new ones
+	this->feedback = feedback;
+	this->feedback->Inject(this->Pool);
+	return true;
+}
+
+void ParticleGenerator::Update(float dt)
+{
+	if (this->feedback)
 	{
-		Particle &p = this->particles[i];
-		p.Life -= dt; // Reduce particle life
-
-		if (p.Life > 0.0f) // Particle is alive thus update
-		{
-			p.Position -= p.Velocity * dt;
-			p.Color.a -= dt * 2.5f;
-		}
+		this->feedback->Inject(this->Pool);
+		this->feedback->Update(dt);
 	}
+	else
+		this->Pool.Update(dt);
 }
 
 void ParticleGenerator::Draw()
 {
-	// Use additive blending to give it a 'glow' effect
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+	if (this->feedback)
+	{
+		GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE);
+		this->feedback->Draw();
+		GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		return;
+	}
 
-	this->shader.Use();
+	// Wait until the GPU has finished drawing from this region (BUFFER_FRAMES
+	// frames ago), which it normally has long since
+	unsigned int region = this->bufferFrame;
+	GLsync fence = static_cast<GLsync>(this->fences[region]);
+	if (fence)
+	{
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+			;
+		glDeleteSync(fence);
+		this->fences[region] = nullptr;
+	}
+
+	std::size_t regionSize = this->amount * sizeof(ParticleInstance);
+	glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+	ParticleInstance *instances = this->mappedInstances
+		? this->mappedInstances + region * this->amount
+		: static_cast<ParticleInstance *>(glMapBufferRange(GL_ARRAY_BUFFER, region * regionSize, regionSize,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
 
-	for (Particle particle : this->particles)
+	unsigned int count = 0;
+	if (instances)
 	{
-		if (particle.Life > 0.0f)
-		{
-			this->shader.SetVector2f("offset", particle.Position);
-			this->shader.SetVector4f("color", particle.Color);
-			this->shader.SetFloat("scale", particle.Scale);
-			this->texture.Bind();
-
-			glBindVertexArray(this->VAO);
-			glDrawArrays(GL_TRIANGLES, 0, 6);
-			glBindVertexArray(0);
-		}
+		const ParticlePool &pool = this->Pool;
+		count = pool.Count();
+		for (unsigned int i = 0; i < count; ++i)
+			instances[i] = { glm::vec2(pool.PositionX[i], pool.PositionY[i]), glm::vec4(pool.Colors[i], pool.Alpha(i)), pool.Scales[i] };
+		if (!this->mappedInstances)
+			glUnmapBuffer(GL_ARRAY_BUFFER);
 	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (count == 0)
+		return;
+
+	// Use additive blending to give it a 'glow' effect
+	GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+	this->shader.Use();
+	this->texture.Bind();
+	GLState::BindVertexArray(this->VAO);
+	this->pointInstanceAttributes(region * regionSize);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+
+	this->fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	this->bufferFrame = (region + 1) % BUFFER_FRAMES;
 
 	// Reset to default blending mode
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 void ParticleGenerator::Init()
 {
+	// The texture may be an atlas image; the GPU path draws with this shader too
+	this->shader.Use().SetVector4f(this->shader.Uniform("region"), this->texture.Region);
+
 	// Setup mesh and attribute properties
 	unsigned int VBO;
 	float particle_quad[] = {
@@ -72,7 +133,7 @@ void ParticleGenerator::Init()
 
 	glGenVertexArrays(1, &this->VAO);
 	glGenBuffers(1, &VBO);
-	glBindVertexArray(this->VAO);
+	GLState::BindVertexArray(this->VAO);
 
 	// Fill mesh buffer
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -81,50 +142,39 @@ void ParticleGenerator::Init()
 	// Set mesh attributes
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
-	glBindVertexArray(0);
 
-	// Create this->Amount default particle instances
-	for (size_t i = 0; i < this->amount; ++i)
-		this->particles.push_back(Particle());
-}
-
-unsigned int ParticleGenerator::FirstUnusedParticle()
-{
-	// First search from last used particle, this will usually return almost instantly
-	for (size_t i = LastUsedParticle; i < this->amount; ++i)
+	// Instance buffer, BUFFER_FRAMES regions of amount particles each
+	glGenBuffers(1, &this->instanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+	GLsizeiptr bufferSize = static_cast<GLsizeiptr>(BUFFER_FRAMES) * this->amount * sizeof(ParticleInstance);
+	if (GLAD_GL_VERSION_4_4)
 	{
-		if (this->particles[i].Life <= 0.0f)
-		{
-			LastUsedParticle = i;
-			return i;
-		}
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, bufferSize, nullptr, flags);
+		this->mappedInstances = static_cast<ParticleInstance *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, flags));
 	}
-
-	// Otherwise, do a linear search
-	for (size_t i = 0; i < LastUsedParticle; ++i)
-	{
-		if (this->particles[i].Life <= 0.0f)
-		{
-			LastUsedParticle = i;
-			return i;
-		}
-	}
-
-	// All particles are taken, override the first one
-	// Note that if it repeatedly hits this case, more particles should be reserved
-	LastUsedParticle = 0;
-	return 0;
+	else
+		glBufferData(GL_ARRAY_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+
+	glEnableVertexAttribArray(1);
+	glVertexAttribDivisor(1, 1);
+	glEnableVertexAttribArray(2);
+	glVertexAttribDivisor(2, 1);
+	glEnableVertexAttribArray(3);
+	glVertexAttribDivisor(3, 1);
+	this->pointInstanceAttributes(0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::BindVertexArray(0);
 }
 
-void ParticleGenerator::RespawnParticle(Particle &particle, GameObject &object, glm::vec2 offset)
+void ParticleGenerator::pointInstanceAttributes(std::size_t offset)
 {
-	float random = ((rand() % 100) - 50) / 10.0f;
-	float rColor = 0.5f + ((rand() % 100) / 100.0f);
-	float rScale = (rand() % 12) + 8.0f;
-
-	particle.Position = object.Position + random + offset;
-	particle.Color = glm::vec4(rColor, rColor, rColor, 1.0f);
-	particle.Scale = rScale;
-	particle.Life = 1.0f;
-	particle.Velocity = object.Velocity * 0.1f;
+	// Re-pointing the attributes selects the region without needing
+	// glDrawArraysInstancedBaseInstance (GL 4.2)
+	glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void *)(offset + offsetof(ParticleInstance, Offset)));
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void *)(offset + offsetof(ParticleInstance, Color)));
+	glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void *)(offset + offsetof(ParticleInstance, Scale)));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
@@ -4,49 +4,63 @@
 #include <glm/glm.hpp>
 #include "Texture.h"
 #include "Shader.h"
-#include "GameObject.h"
-#include <vector>
+#include "ParticleFeedback.h"
+#include "ParticlePool.h"
+#include <cstddef>
+#include <cstdint>
 
-struct Particle
+// Per-instance data of one drawn particle, as read by particle.vert
+struct ParticleInstance
 {
-	glm::vec2 Position, Velocity;
+	glm::vec2 Offset;
 	glm::vec4 Color;
 	float Scale;
-	float Life;
-
-	Particle()
-		: Position(0.0f), Velocity(0.0f), Color(1.0f), Scale(10.0f), Life(0.0f)
-	{
-	}
 };
 
+// Draws the particles of a ParticlePool. Emitters spawn into Pool; a
+// particle's position is the top-left corner of its quad. By default the
+// pool is simulated on the CPU; UseTransformFeedback moves it to the GPU
 class ParticleGenerator
 {
 public:
-	ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
+	ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, std::uint64_t seed = Random::DEFAULT_SEED);
+	~ParticleGenerator();
+
+	ParticlePool Pool;
 
-	void Update(float dt, GameObject &object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f));
+	// Switches to the GPU path (see ParticleFeedback): particles spawned into
+	// Pool are handed to the GPU every Update and advanced there. Returns
+	// false, staying on the CPU path, if the update program can't be built
+	bool UseTransformFeedback();
+	bool UsesTransformFeedback() const { return this->feedback != nullptr; }
+
+	void Update(float dt);
 	void Draw();
 
 private:
-	std::vector<Particle> particles;
 	unsigned int amount;
 
-	// Stores the index of the last particle used (for quick access to next dead particle)
-	unsigned int LastUsedParticle = 0;
-
 	Shader shader;
 	Texture2D texture;
 	unsigned int VAO;
 
+	// Live particles are streamed into one of BUFFER_FRAMES regions of the
+	// instance buffer per frame and drawn with one instanced call. Each
+	// region is fenced, so it is only rewritten once the GPU is done with it.
+	// With GL 4.4 the buffer stays mapped for its whole lifetime. Needs GL 3.3
+	static const unsigned int BUFFER_FRAMES = 3;
+	unsigned int instanceVBO;
+	ParticleInstance *mappedInstances = nullptr;
+	void *fences[BUFFER_FRAMES] = {};
+	unsigned int bufferFrame = 0;
+
+	ParticleFeedback *feedback = nullptr;
+
 	// Initializes buffer and vertex attributes
 	void Init();
 
-	// Returns the first Particle index that's currently unused
-	// e.g. Life <= 0.0f or 0 if no particle is currently inactive
-	unsigned int FirstUnusedParticle();
-
-	void RespawnParticle(Particle &particle, GameObject &object, glm::vec2 offset = glm::vec2(0.0f));
+	// Points the instance attributes at the region starting at offset (bytes)
+	void pointInstanceAttributes(std::size_t offset);
 };
 
 #endif // !PARTICLE_GENERATOR_H
\ No newline at end of file
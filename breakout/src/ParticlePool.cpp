@@ -0,0 +1,258 @@
+#include "ParticlePool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLES_SSE2
+#include <emmintrin.h>
+#endif
+
+// Pools smaller than this per thread are updated on the calling thread, as
+// waking the workers would cost more than it saves
+static const unsigned int MIN_PARTICLES_PER_THREAD = 65536;
+
+// The clock is moved back to 0 once it passes this many seconds, so it keeps
+// enough float precision to advance by a tick
+static const float CLOCK_REBASE = 64.0f;
+
+// Random values drawn per spawned particle: jitter x, jitter y, direction,
+// speed, scale, brightness
+static const unsigned int RANDOMS_PER_PARTICLE = 6;
+
+ParticlePool::ParticlePool(unsigned int capacity, std::uint64_t seed)
+	: capacity(capacity), nextDeath(std::numeric_limits<float>::infinity()), random(seed)
+{
+	this->PositionX.resize(capacity);
+	this->PositionY.resize(capacity);
+	this->VelocityX.resize(capacity);
+	this->VelocityY.resize(capacity);
+	this->Death.resize(capacity);
+	this->Fade.resize(capacity);
+	this->Colors.resize(capacity);
+	this->Scales.resize(capacity);
+}
+
+ParticlePool::~ParticlePool()
+{
+	this->SetThreads(1);
+}
+
+void ParticlePool::SetThreads(unsigned int threads)
+{
+	threads = std::max(threads, 1u);
+	if (threads == this->Threads())
+		return;
+
+	// Stop the current workers, then start the new set
+	{
+		std::lock_guard<std::mutex> lock(this->workMutex);
+		this->stopping = true;
+	}
+	this->workStarted.notify_all();
+	for (std::thread &worker : this->workers)
+		worker.join();
+	this->workers.clear();
+
+	this->stopping = false;
+	for (unsigned int t = 1; t < threads; ++t)
+		this->workers.emplace_back(&ParticlePool::work, this, t, this->generation);
+}
+
+void ParticlePool::Clear()
+{
+	this->count = 0;
+	this->nextDeath = std::numeric_limits<float>::infinity();
+}
+
+void ParticlePool::Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec3 color, float scale, float life)
+{
+	if (this->count == this->capacity)
+	{
+		++this->Dropped;
+		return;
+	}
+
+	unsigned int i = this->count++;
+	this->PositionX[i] = position.x;
+	this->PositionY[i] = position.y;
+	this->VelocityX[i] = velocity.x;
+	this->VelocityY[i] = velocity.y;
+	this->Death[i] = this->time + std::max(life, 1e-6f);
+	this->Fade[i] = 1.0f / std::max(life, 1e-6f);
+	this->nextDeath = std::min(this->nextDeath, this->Death[i]);
+	this->Colors[i] = color;
+	this->Scales[i] = scale;
+}
+
+void ParticlePool::Emit(ParticleEmitter &emitter, float dt, glm::vec2 position, glm::vec2 velocity, glm::vec3 color)
+{
+	emitter.Pending += emitter.Rate * dt;
+	unsigned int count = static_cast<unsigned int>(emitter.Pending);
+	emitter.Pending -= static_cast<float>(count);
+	this->spawn(emitter, count, position, velocity, color);
+}
+
+void ParticlePool::Burst(const ParticleEmitter &emitter, unsigned int count, glm::vec2 position, glm::vec2 velocity, glm::vec3 color)
+{
+	this->spawn(emitter, count, position, velocity, color);
+}
+
+void ParticlePool::spawn(const ParticleEmitter &emitter, unsigned int count, glm::vec2 position, glm::vec2 velocity, glm::vec3 color)
+{
+	unsigned int room = this->capacity - this->count;
+	if (count > room)
+	{
+		this->Dropped += count - room;
+		count = room;
+	}
+	if (count == 0)
+		return;
+
+	// Draw every random value of the batch at once
+	this->spawnRandoms.resize(count * RANDOMS_PER_PARTICLE);
+	this->random.FillRange(this->spawnRandoms.data(), this->spawnRandoms.size(), 0.0f, 1.0f);
+
+	glm::vec2 inherited = velocity * emitter.VelocityScale;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const float *r = &this->spawnRandoms[i * RANDOMS_PER_PARTICLE];
+		glm::vec2 jitter = (glm::vec2(r[0], r[1]) * 2.0f - 1.0f) * emitter.Jitter;
+		float angle = r[2] * 6.2831853f;
+		glm::vec2 scatter = glm::vec2(std::cos(angle), std::sin(angle)) * (r[3] * emitter.Speed);
+		float scale = emitter.MinScale + r[4] * (emitter.MaxScale - emitter.MinScale);
+		float brightness = emitter.MinBrightness + r[5] * (emitter.MaxBrightness - emitter.MinBrightness);
+		this->Spawn(position + jitter, inherited + scatter, color * brightness, scale, emitter.Life);
+	}
+}
+
+void ParticlePool::Update(float dt)
+{
+	unsigned int threads = std::min(this->Threads(), this->count / MIN_PARTICLES_PER_THREAD);
+	if (threads <= 1)
+		this->integrate(0, this->count, dt);
+	else
+	{
+		// Chunks are multiples of 4, so only the last one has a scalar tail.
+		// Workers past the last chunk get an empty range
+		std::unique_lock<std::mutex> lock(this->workMutex);
+		this->chunk = (this->count / threads + 3) & ~3u;
+		this->workDt = dt;
+		this->pending = static_cast<unsigned int>(this->workers.size());
+		++this->generation;
+		lock.unlock();
+		this->workStarted.notify_all();
+
+		this->integrate(0, std::min(this->chunk, this->count), dt);
+
+		lock.lock();
+		this->workFinished.wait(lock, [this]() { return this->pending == 0; });
+	}
+
+	this->time += dt;
+	if (this->time >= this->nextDeath)
+		this->removeDead();
+
+	if (this->time >= CLOCK_REBASE)
+	{
+		for (unsigned int i = 0; i < this->count; ++i)
+			this->Death[i] -= this->time;
+		this->nextDeath -= this->time;
+		this->time = 0.0f;
+	}
+}
+
+void ParticlePool::integrate(unsigned int begin, unsigned int end, float dt)
+{
+	IntegrateParticles(this->PositionX.data(), this->PositionY.data(), this->VelocityX.data(), this->VelocityY.data(),
+		begin, end, dt);
+}
+
+void ParticlePool::work(unsigned int worker, unsigned long long seen)
+{
+	std::unique_lock<std::mutex> lock(this->workMutex);
+	while (true)
+	{
+		this->workStarted.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+		if (this->stopping)
+			return;
+		seen = this->generation;
+		unsigned int begin = std::min(worker * this->chunk, this->count);
+		unsigned int end = std::min((worker + 1) * this->chunk, this->count);
+		float dt = this->workDt;
+		lock.unlock();
+
+		this->integrate(begin, end, dt);
+
+		lock.lock();
+		if (--this->pending == 0)
+			this->workFinished.notify_one();
+	}
+}
+
+void ParticlePool::removeDead()
+{
+	// Walking backwards, the last particle that fills a hole has already been
+	// checked, so it is always a live one
+	this->nextDeath = std::numeric_limits<float>::infinity();
+	for (unsigned int i = this->count; i-- > 0;)
+	{
+		if (this->Death[i] <= this->time)
+			this->remove(i);
+		else
+			this->nextDeath = std::min(this->nextDeath, this->Death[i]);
+	}
+}
+
+void ParticlePool::remove(unsigned int particle)
+{
+	unsigned int last = --this->count;
+	if (particle == last)
+		return;
+	this->PositionX[particle] = this->PositionX[last];
+	this->PositionY[particle] = this->PositionY[last];
+	this->VelocityX[particle] = this->VelocityX[last];
+	this->VelocityY[particle] = this->VelocityY[last];
+	this->Death[particle] = this->Death[last];
+	this->Fade[particle] = this->Fade[last];
+	this->Colors[particle] = this->Colors[last];
+	this->Scales[particle] = this->Scales[last];
+}
+
+void IntegrateParticlesScalar(float *positionX, float *positionY, const float *velocityX, const float *velocityY,
+	unsigned int begin, unsigned int end, float dt)
+{
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		positionX[i] += velocityX[i] * dt;
+		positionY[i] += velocityY[i] * dt;
+	}
+}
+
+#if defined(PARTICLES_SSE2)
+
+void IntegrateParticles(float *positionX, float *positionY, const float *velocityX, const float *velocityY,
+	unsigned int begin, unsigned int end, float dt)
+{
+	const __m128 step = _mm_set1_ps(dt);
+
+	unsigned int i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), step)));
+		_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(_mm_loadu_ps(velocityY + i), step)));
+	}
+
+	IntegrateParticlesScalar(positionX, positionY, velocityX, velocityY, i, end, dt);
+}
+
+#else
+
+void IntegrateParticles(float *positionX, float *positionY, const float *velocityX, const float *velocityY,
+	unsigned int begin, unsigned int end, float dt)
+{
+	IntegrateParticlesScalar(positionX, positionY, velocityX, velocityY, begin, end, dt);
+}
+
+#endif
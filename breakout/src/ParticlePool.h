@@ -0,0 +1,126 @@
+#ifndef PARTICLE_POOL_H
+#define PARTICLE_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Random.h"
+
+// How an emitter spawns particles. A particle starts fully opaque and fades
+// out linearly over Life seconds; it is removed from the pool once invisible.
+struct ParticleEmitter
+{
+	float Rate = 0.0f;			// particles per second spawned by ParticlePool::Emit
+	float Life = 0.4f;			// seconds until a particle has faded out
+	float Jitter = 5.0f;		// random offset from the emit position, per axis
+	float VelocityScale = 0.0f;	// fraction of the source velocity particles inherit
+	float Speed = 0.0f;			// plus a random velocity of up to this length
+	float MinScale = 8.0f, MaxScale = 20.0f;
+	float MinBrightness = 0.5f, MaxBrightness = 1.5f; // multiplies the emit color
+
+	// Fraction of a particle carried over between Emit calls, so the rate
+	// doesn't depend on how often Emit is called
+	float Pending = 0.0f;
+};
+
+// Fixed-capacity pool of particles shared by any number of emitters. State
+// is stored as a structure of arrays and live particles are kept packed in
+// [0, Count()): spawning appends, and a dead particle is replaced by the
+// last live one. Update only streams the positions and velocities of live
+// particles, 4 at a time with SSE2 (scalar code elsewhere); alpha is derived
+// from the pool clock when drawing, and the death times are only scanned
+// once the earliest of them has passed. With SetThreads, large pools are
+// split across a set of worker threads that lives as long as the pool.
+// Doesn't use GL (see ParticleGenerator for drawing), so it's part of the
+// simulation library and can be benchmarked headless
+// (breakout_sim --particle-bench).
+class ParticlePool
+{
+public:
+	// Live particle state, valid in [0, Count())
+	std::vector<float> PositionX, PositionY;
+	std::vector<float> VelocityX, VelocityY;
+	std::vector<float> Death;		// pool time at which the particle has faded out
+	std::vector<float> Fade;		// alpha lost per second
+	std::vector<glm::vec3> Colors;
+	std::vector<float> Scales;
+
+	// Particles that didn't fit since construction, for tuning the capacity
+	unsigned long long Dropped = 0;
+
+	explicit ParticlePool(unsigned int capacity, std::uint64_t seed = Random::DEFAULT_SEED);
+	~ParticlePool();
+
+	ParticlePool(const ParticlePool &) = delete;
+	ParticlePool &operator=(const ParticlePool &) = delete;
+
+	unsigned int Count() const { return this->count; }
+	unsigned int Capacity() const { return this->capacity; }
+
+	// Opacity of a live particle: 1 when spawned, 0 once it has faded out
+	float Alpha(unsigned int particle) const { return (this->Death[particle] - this->time) * this->Fade[particle]; }
+
+	// Number of threads Update uses for large pools, the calling one included.
+	// Starts or stops workers, so call it once rather than per update
+	void SetThreads(unsigned int threads);
+	unsigned int Threads() const { return static_cast<unsigned int>(this->workers.size()) + 1; }
+
+	// Adds one particle; it is dropped when the pool is full
+	void Spawn(glm::vec2 position, glm::vec2 velocity, glm::vec3 color, float scale, float life);
+
+	// Spawns emitter.Rate * dt particles (carrying fractions over to the next
+	// call) around position
+	void Emit(ParticleEmitter &emitter, float dt, glm::vec2 position, glm::vec2 velocity, glm::vec3 color = glm::vec3(1.0f));
+
+	// Spawns count particles at once around position
+	void Burst(const ParticleEmitter &emitter, unsigned int count, glm::vec2 position, glm::vec2 velocity, glm::vec3 color = glm::vec3(1.0f));
+
+	// Moves every live particle, advances the pool clock by dt and removes the
+	// particles that faded out
+	void Update(float dt);
+
+	void Clear();
+
+private:
+	unsigned int capacity;
+	unsigned int count = 0;
+
+	// Pool clock, and the earliest death time of a live particle
+	float time = 0.0f;
+	float nextDeath;
+
+	Random random;
+	std::vector<float> spawnRandoms;
+
+	// Worker threads; each integrates its chunk of the pool when generation
+	// changes and counts down pending when done
+	std::vector<std::thread> workers;
+	std::mutex workMutex;
+	std::condition_variable workStarted, workFinished;
+	unsigned long long generation = 0;
+	unsigned int pending = 0;
+	unsigned int chunk = 0;
+	float workDt = 0.0f;
+	bool stopping = false;
+
+	void spawn(const ParticleEmitter &emitter, unsigned int count, glm::vec2 position, glm::vec2 velocity, glm::vec3 color);
+	void remove(unsigned int particle);
+	void removeDead();
+	void work(unsigned int worker, unsigned long long seen);
+	void integrate(unsigned int begin, unsigned int end, float dt);
+};
+
+// Integrates particles [begin, end): moves them by velocity * dt
+void IntegrateParticles(float *positionX, float *positionY, const float *velocityX, const float *velocityY,
+	unsigned int begin, unsigned int end, float dt);
+
+// Scalar reference implementation of IntegrateParticles
+void IntegrateParticlesScalar(float *positionX, float *positionY, const float *velocityX, const float *velocityY,
+	unsigned int begin, unsigned int end, float dt);
+
+#endif // !PARTICLE_POOL_H
@@ -1,10 +1,10 @@
 #include <glad/glad.h>
 #include "PostProcessor.h"
+#include "GLState.h"
 #include <iostream>
 
 PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int height)
-	: PostProcessingShader(shader), Texture(), Width(width), Height(height), 
-	Confuse(false), Chaos(false), Shake(false)
+	: PostProcessingShader(shader), Texture(), Width(width), Height(height)
 {
 	// Initialize render buffer / frame buffer object
 	glGenFramebuffers(1, &this->MSFBO);
@@ -12,7 +12,7 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
 	glGenRenderbuffers(1, &this->RBO);
 
 	// Initialize render buffer storage with a multi-sampled color buffer (don't need a depth/stencil buffer)
-	glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
 	glBindRenderbuffer(GL_RENDERBUFFER, this->RBO);
 
 	// Allocate storage for render buffer object
@@ -26,7 +26,7 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
 
 	// Initialize the FBO/Texture to blit multi-sampled color-buffer to;
 	// Used for shader operations (for post-processing effects)
-	glBindFramebuffer(GL_FRAMEBUFFER, this->FBO);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, this->FBO);
 	this->Texture.Generate(width, height, NULL);
 
 	// Attach texture to frame buffer as its color attachment
@@ -35,7 +35,7 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
 	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
 		std::cout << "ERROR::POSTPROCESSOR: Failed to initialize FBO" << std::endl;
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
 	// Initialize render data and uniforms
 	this->InitRenderData();
@@ -53,26 +53,26 @@ PostProcessor::PostProcessor(Shader shader, unsigned int width, unsigned int hei
 		{  offset, -offset  }   // bottom-right    
 	};
 
-	glUniform2fv(glGetUniformLocation(this->PostProcessingShader.ID, "offsets"), 9, (float *)offsets);
+	glUniform2fv(this->PostProcessingShader.Uniform("offsets"), 9, (float *)offsets);
 
 	int edge_kernel[9] = {
 		-1, -1, -1,
 		-1,  8, -1,
 		-1, -1, -1
 	};
-	glUniform1iv(glGetUniformLocation(this->PostProcessingShader.ID, "edge_kernel"), 9, edge_kernel);
+	glUniform1iv(this->PostProcessingShader.Uniform("edge_kernel"), 9, edge_kernel);
 	
 	float blur_kernel[9] = {
 		1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f,
 		2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f,
 		1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f
 	};
-	glUniform1fv(glGetUniformLocation(this->PostProcessingShader.ID, "blur_kernel"), 9, blur_kernel);
+	glUniform1fv(this->PostProcessingShader.Uniform("blur_kernel"), 9, blur_kernel);
 }
 
 void PostProcessor::BeginRender()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, this->MSFBO);
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
@@ -80,29 +80,22 @@ void PostProcessor::BeginRender()
 void PostProcessor::EndRender()
 {
 	// Resolve multi-sampled color-buffer into intermediate FBO to store to texture
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
+	GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, this->MSFBO);
+	GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, this->FBO);
 	glBlitFramebuffer(0, 0, this->Width, this->Height, 0, 0, this->Width, this->Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 	
 	// Binds both READ and WRITE frame-buffer to default frame-buffer
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void PostProcessor::Render(float time)
+void PostProcessor::Render()
 {
-	// Set uniforms/options
 	this->PostProcessingShader.Use();
-	this->PostProcessingShader.SetFloat("time", time);
-	this->PostProcessingShader.SetInteger("confuse", this->Confuse);
-	this->PostProcessingShader.SetInteger("chaos", this->Chaos);
-	this->PostProcessingShader.SetInteger("shake", this->Shake);
-	
+
 	// Render textured quad
-	glActiveTexture(GL_TEXTURE0);
 	this->Texture.Bind();
-	glBindVertexArray(this->VAO);
+	GLState::BindVertexArray(this->VAO);
 	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glBindVertexArray(0);
 }
 
 void PostProcessor::InitRenderData()
@@ -125,9 +118,9 @@ void PostProcessor::InitRenderData()
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-	glBindVertexArray(this->VAO);
+	GLState::BindVertexArray(this->VAO);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 }
@@ -11,9 +11,6 @@ public:
 	Texture2D Texture;
 	unsigned int Width, Height;
 
-	// Options
-	bool Confuse, Chaos, Shake;
-
 	PostProcessor(Shader shader, unsigned int width, unsigned int height);
 
 	// Prepares the PostProcessor's frame buffer operations before rendering the game
@@ -22,8 +19,9 @@ public:
 	// Should be called after rendering the game, so it stores all the rendered data into a texture object
 	void EndRender();
 
-	// Renders the PostProcessor texture quad (as a screen-encompassing large sprite)
-	void Render(float time);
+	// Renders the PostProcessor texture quad (as a screen-encompassing large sprite).
+	// The effect flags and time come from the FrameData uniform block
+	void Render();
 
 private:
 	// Render state
@@ -4,22 +4,70 @@
 #include <glm/glm.hpp>
 #include "GameObject.h"
 
+class Simulation;
+
 const glm::vec2 SIZE(60.0f, 20.0f);
 const glm::vec2 VELOCITY(0.0f, 150.0f);
 
+enum PowerUpType
+{
+    POWERUP_SPEED,
+    POWERUP_STICKY,
+    POWERUP_PASS_THROUGH,
+    POWERUP_PAD_SIZE_INCREASE,
+    POWERUP_CONFUSE,
+    POWERUP_CHAOS,
+    POWERUP_MULTI_BALL,
+    POWERUP_TYPE_COUNT
+};
+
+// Everything that differs between power-up types. The table itself lives in
+// Simulation.cpp (see Simulation::PowerUpInfo)
+struct PowerUpDefinition
+{
+    const char *Name;
+    unsigned int SpawnWeight;           // chance per destroyed brick, in 1/POWERUP_SPAWN_ROLL
+    float Duration;                     // seconds, 0 for one-shot effects
+    glm::vec3 Color;
+    const char *Texture;                // ResourceManager texture name
+    void (*Activate)(Simulation &sim);
+    void (*Deactivate)(Simulation &sim); // nullptr if there is nothing to undo
+};
+
+// Range of the single roll SpawnPowerUps does per destroyed brick
+const unsigned int POWERUP_SPAWN_ROLL = 75;
+
 class PowerUp : public GameObject
 {
 public:
     // Powerup state
-    std::string Type;
+    PowerUpType Type;
     float Duration;
     bool Activated;
 
-    PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Texture2D texture)
-        : GameObject(position, SIZE, texture, color, VELOCITY), Type(type), Duration(duration), Activated()
+    PowerUp()
+        : GameObject(), Type(POWERUP_SPEED), Duration(0.0f), Activated(false)
+    {
+    }
+
+    PowerUp(PowerUpType type, glm::vec3 color, float duration, glm::vec2 position)
+        : GameObject(position, SIZE, color, VELOCITY), Type(type), Duration(duration), Activated()
+    {
+    }
+
+    void Save(ByteWriter &out) const
     {
+        GameObject::Save(out);
+        out.Put(this->Type);
+        out.Put(this->Duration);
+        out.Put(this->Activated);
+    }
+
+    bool Restore(ByteReader &in)
+    {
+        return GameObject::Restore(in) && in.Get(this->Type) && in.Get(this->Duration) && in.Get(this->Activated)
+            && this->Type < POWERUP_TYPE_COUNT;
     }
 };
 
 #endif // !POWER_UP_H
-
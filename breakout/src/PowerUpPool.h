@@ -0,0 +1,141 @@
+#ifndef POWER_UP_POOL_H
+#define POWER_UP_POOL_H
+
+#include <cstdint>
+
+#include "PowerUp.h"
+
+// Refers to a pooled power-up. Stays valid while the power-up lives; once its
+// slot is released and reused the generation no longer matches.
+struct PowerUpHandle
+{
+	std::uint16_t Index;
+	std::uint16_t Generation;
+};
+
+// Fixed-capacity storage for power-ups. Slots are recycled through a free
+// list, so spawning and expiring never allocate and live power-ups never move.
+class PowerUpPool
+{
+public:
+	static const unsigned int CAPACITY = 64;
+
+	PowerUpPool()
+	{
+		this->Clear();
+	}
+
+	// Puts a copy of powerUp in a free slot. Returns false (and drops the
+	// power-up) if the pool is full
+	bool Spawn(const PowerUp &powerUp, PowerUpHandle *handle = nullptr)
+	{
+		if (this->freeCount == 0)
+			return false;
+
+		std::uint16_t index = this->freeList[--this->freeCount];
+		this->slots[index] = powerUp;
+		this->alive[index] = true;
+		++this->size;
+
+		if (handle)
+			*handle = { index, this->generations[index] };
+		return true;
+	}
+
+	// Returns the slot to the free list, invalidating handles to it
+	void Release(unsigned int index)
+	{
+		if (!this->alive[index])
+			return;
+
+		this->alive[index] = false;
+		++this->generations[index];
+		this->freeList[this->freeCount++] = static_cast<std::uint16_t>(index);
+		--this->size;
+	}
+
+	// Releases every slot
+	void Clear()
+	{
+		for (unsigned int i = 0; i < CAPACITY; ++i)
+		{
+			if (this->alive[i])
+				++this->generations[i];
+			this->alive[i] = false;
+			// Hand out low slots first
+			this->freeList[i] = static_cast<std::uint16_t>(CAPACITY - 1 - i);
+		}
+		this->freeCount = CAPACITY;
+		this->size = 0;
+	}
+
+	// The power-up a handle refers to, or nullptr if it has been released
+	PowerUp *Get(PowerUpHandle handle)
+	{
+		if (handle.Index >= CAPACITY || !this->alive[handle.Index] || this->generations[handle.Index] != handle.Generation)
+			return nullptr;
+		return &this->slots[handle.Index];
+	}
+
+	// Saves every slot and the free list, so a restored pool hands out the
+	// same slots in the same order
+	void Save(ByteWriter &out) const
+	{
+		for (unsigned int i = 0; i < CAPACITY; ++i)
+		{
+			out.Put(this->alive[i]);
+			out.Put(this->generations[i]);
+			if (this->alive[i])
+				this->slots[i].Save(out);
+		}
+		out.PutBytes(this->freeList, this->freeCount * sizeof(std::uint16_t));
+	}
+
+	bool Restore(ByteReader &in)
+	{
+		this->size = 0;
+		for (unsigned int i = 0; i < CAPACITY; ++i)
+		{
+			if (!in.Get(this->alive[i]) || !in.Get(this->generations[i]))
+				return false;
+			if (this->alive[i])
+			{
+				if (!this->slots[i].Restore(in))
+					return false;
+				++this->size;
+			}
+		}
+		this->freeCount = CAPACITY - this->size;
+		if (!in.GetBytes(this->freeList, this->freeCount * sizeof(std::uint16_t)))
+			return false;
+
+		// Snapshots come from replay files too, so the free list must name
+		// every dead slot exactly once before Spawn may index with it
+		bool listed[CAPACITY] = {};
+		for (unsigned int i = 0; i < this->freeCount; ++i)
+		{
+			std::uint16_t index = this->freeList[i];
+			if (index >= CAPACITY || this->alive[index] || listed[index])
+				return false;
+			listed[index] = true;
+		}
+		return true;
+	}
+
+	// Slot access for iteration: for (i < Capacity()) if (IsAlive(i)) ... [i]
+	unsigned int Capacity() const { return CAPACITY; }
+	unsigned int Size() const { return this->size; }
+	bool IsAlive(unsigned int index) const { return this->alive[index]; }
+	PowerUp &operator[](unsigned int index) { return this->slots[index]; }
+	const PowerUp &operator[](unsigned int index) const { return this->slots[index]; }
+
+private:
+	PowerUp slots[CAPACITY];
+	bool alive[CAPACITY] = {};
+	std::uint16_t generations[CAPACITY] = {};
+	std::uint16_t freeList[CAPACITY];
+	unsigned int freeCount;
+	unsigned int size;
+};
+
+#endif // !POWER_UP_POOL_H
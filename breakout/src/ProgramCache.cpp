@@ -0,0 +1,151 @@
+#include "ProgramCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "ByteStream.h"
+
+// Cache file header: "BKPB", then the version of this layout
+static const std::uint32_t MAGIC = 0x42504B42;
+static const std::uint32_t VERSION = 1;
+
+std::string ProgramCache::Directory;
+unsigned int ProgramCache::Hits = 0;
+unsigned int ProgramCache::Misses = 0;
+
+// Binary formats the driver accepts, queried on first use
+static bool queried = false;
+static std::vector<int> formats;
+
+static bool enabled()
+{
+	if (ProgramCache::Directory.empty())
+		return false;
+	if (!queried)
+	{
+		queried = true;
+		// Program binaries are core in GL 4.1; the loader doesn't load extensions
+		if (GLAD_GL_VERSION_4_1)
+		{
+			int count = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+			formats.resize(count);
+			if (count > 0)
+				glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+		}
+	}
+	return !formats.empty();
+}
+
+static std::string path(std::uint64_t key)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+	return (std::filesystem::path(ProgramCache::Directory) / name).string();
+}
+
+// FNV-1a, as Simulation::StateHash
+static std::uint64_t hash(std::uint64_t hash, const char *bytes, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; ++i)
+		hash = (hash ^ static_cast<std::uint8_t>(bytes[i])) * 0x100000001B3ull;
+	return hash;
+}
+
+std::uint64_t ProgramCache::Key(const std::string &sources)
+{
+	std::uint64_t key = 0xCBF29CE484222325ull;
+	const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+	for (GLenum name : driverStrings)
+	{
+		const char *value = reinterpret_cast<const char *>(glGetString(name));
+		std::string driver = value ? value : "";
+		key = hash(key, driver.c_str(), driver.size() + 1);
+	}
+	return hash(key, sources.data(), sources.size());
+}
+
+unsigned int ProgramCache::Load(std::uint64_t key)
+{
+	if (!enabled())
+		return 0;
+
+	std::ifstream stream(path(key), std::ios::binary);
+	std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	ByteReader reader(data.data(), data.size());
+	std::uint32_t magic = 0, version = 0;
+	std::uint64_t storedKey = 0, size = 0;
+	int format = 0;
+	reader.Get(magic);
+	reader.Get(version);
+	reader.Get(storedKey);
+	reader.Get(format);
+	reader.GetVarint(size);
+	const std::uint8_t *binary = reader.Skip(static_cast<std::size_t>(size));
+
+	// Checking the format first keeps a binary from another driver from raising a GL error
+	if (!binary || magic != MAGIC || version != VERSION || storedKey != key
+		|| std::find(formats.begin(), formats.end(), format) == formats.end())
+	{
+		++Misses;
+		return 0;
+	}
+
+	unsigned int program = glCreateProgram();
+	glProgramBinary(program, format, binary, static_cast<GLsizei>(size));
+	int success;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glDeleteProgram(program);
+		++Misses;
+		return 0;
+	}
+	++Hits;
+	return program;
+}
+
+void ProgramCache::PrepareLink(unsigned int program)
+{
+	if (enabled())
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::Store(std::uint64_t key, unsigned int program)
+{
+	int success = 0, length = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!enabled() || !success)
+		return;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<std::uint8_t> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	std::vector<std::uint8_t> data;
+	ByteWriter writer(data);
+	writer.Put(MAGIC);
+	writer.Put(VERSION);
+	writer.Put(key);
+	writer.Put(static_cast<int>(format));
+	writer.PutVarint(static_cast<std::uint64_t>(length));
+	writer.PutBytes(binary.data(), static_cast<std::size_t>(length));
+
+	std::error_code error;
+	std::filesystem::create_directories(Directory, error);
+	std::ofstream stream(path(key), std::ios::binary);
+	stream.write(reinterpret_cast<const char *>(data.data()), data.size());
+	if (!stream)
+		std::cout << "ERROR::SHADER: Failed to write program binary " << path(key) << std::endl;
+}
@@ -0,0 +1,43 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+// Keeps linked shader programs on disk (glGetProgramBinary) so later runs
+// can load them with glProgramBinary instead of compiling and linking from
+// source. A program is keyed by a hash of its sources and of the driver
+// (vendor, renderer and version strings), so an edited shader or an updated
+// driver just misses. A binary the driver still rejects is recompiled from
+// source and overwritten. Shader::Compile and Shader::CompileFeedback go
+// through here. The cache stays off while Directory is empty, before GL 4.1
+// and when the driver supports no binary formats. Like ResourceManager, all
+// functions are static.
+class ProgramCache
+{
+public:
+	// Directory the binaries are kept in, created when needed; empty: off
+	static std::string Directory;
+
+	// Programs loaded from the cache and built from source since startup
+	static unsigned int Hits, Misses;
+
+	// Key of a program built from sources: every stage's source and anything
+	// else that changes the program, joined
+	static std::uint64_t Key(const std::string &sources);
+
+	// Creates a program from the binary stored under key, or returns 0 if
+	// there is none or the driver rejects it
+	static unsigned int Load(std::uint64_t key);
+
+	// Asks GL to keep the binary of program retrievable; call before linking
+	static void PrepareLink(unsigned int program);
+
+	// Stores the binary of program under key, if it linked
+	static void Store(std::uint64_t key, unsigned int program);
+
+private:
+	ProgramCache() {}
+};
+
+#endif // !PROGRAM_CACHE_H
@@ -0,0 +1,91 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Small, fast, seedable random number stream (xoshiro128**). Every Simulation
+// and ParticleGenerator owns one, so runs are reproducible from a seed and
+// separate instances never share state (unlike rand()).
+class Random
+{
+public:
+	static const std::uint64_t DEFAULT_SEED = 0x2545F4914F6CDD1Dull;
+
+	// Generator state, exposed so it can be saved and restored
+	std::uint32_t State[4];
+
+	explicit Random(std::uint64_t seed = DEFAULT_SEED)
+	{
+		this->Seed(seed);
+	}
+
+	// Expands a 64-bit seed into the full state with splitmix64
+	void Seed(std::uint64_t seed)
+	{
+		for (int i = 0; i < 4; i += 2)
+		{
+			std::uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			z ^= z >> 31;
+			this->State[i] = static_cast<std::uint32_t>(z);
+			this->State[i + 1] = static_cast<std::uint32_t>(z >> 32);
+		}
+	}
+
+	std::uint32_t Next()
+	{
+		std::uint32_t *s = this->State;
+		std::uint32_t result = rotl(s[1] * 5, 7) * 9;
+		std::uint32_t t = s[1] << 9;
+
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 11);
+
+		return result;
+	}
+
+	// Uniform integer in [0, bound)
+	std::uint32_t Below(std::uint32_t bound)
+	{
+		return static_cast<std::uint32_t>((static_cast<std::uint64_t>(this->Next()) * bound) >> 32);
+	}
+
+	// Uniform float in [0, 1)
+	float Float()
+	{
+		return (this->Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Uniform float in [min, max)
+	float Range(float min, float max)
+	{
+		return min + (max - min) * this->Float();
+	}
+
+	// Bulk versions, for callers that need many values at once
+	void Fill(std::uint32_t *out, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			out[i] = this->Next();
+	}
+
+	void FillRange(float *out, std::size_t count, float min, float max)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			out[i] = this->Range(min, max);
+	}
+
+private:
+	static std::uint32_t rotl(std::uint32_t x, int k)
+	{
+		return (x << k) | (x >> (32 - k));
+	}
+};
+
+#endif // !RANDOM_H
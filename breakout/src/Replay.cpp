@@ -0,0 +1,244 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "ByteStream.h"
+
+const std::uint32_t Replay::MAGIC;
+const std::uint32_t Replay::VERSION;
+
+std::uint8_t PackInput(const SimInput &input)
+{
+	return static_cast<std::uint8_t>((input.Left ? 1 : 0) | (input.Right ? 2 : 0) | (input.Launch ? 4 : 0));
+}
+
+SimInput UnpackInput(std::uint8_t bits)
+{
+	SimInput input;
+	input.Left = (bits & 1) != 0;
+	input.Right = (bits & 2) != 0;
+	input.Launch = (bits & 4) != 0;
+	return input;
+}
+
+// Replays store 32-bit hashes
+static std::uint32_t FoldHash(std::uint64_t hash)
+{
+	return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+bool Replay::Save(const char *file) const
+{
+	std::vector<std::uint8_t> data;
+	ByteWriter writer(data);
+
+	writer.Put(MAGIC);
+	writer.Put(VERSION);
+	writer.Put(this->Seed);
+	writer.Put(this->Level);
+	writer.Put(this->TickTime);
+	writer.Put(this->KeyframeInterval);
+	writer.PutVarint(this->TickCount);
+
+	writer.PutVarint(this->Inputs.size());
+	std::uint64_t previousTick = 0;
+	for (const InputChange &change : this->Inputs)
+	{
+		writer.PutVarint((change.Tick - previousTick) << 3 | change.Input);
+		previousTick = change.Tick;
+	}
+
+	writer.PutBytes(this->Hashes.data(), this->Hashes.size() * sizeof(std::uint32_t));
+
+	writer.PutVarint(this->Keyframes.size());
+	for (const Keyframe &keyframe : this->Keyframes)
+	{
+		writer.PutVarint(keyframe.Tick);
+		writer.PutVarint(keyframe.InputIndex);
+		writer.PutVarint(keyframe.State.size());
+		writer.PutBytes(keyframe.State.data(), keyframe.State.size());
+	}
+
+	std::ofstream stream(file, std::ios::binary);
+	stream.write(reinterpret_cast<const char *>(data.data()), data.size());
+	if (!stream)
+	{
+		std::cout << "ERROR::REPLAY: Failed to write replay file " << file << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool Replay::Load(const char *file)
+{
+	std::ifstream stream(file, std::ios::binary);
+	std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	if (!stream.good() && !stream.eof())
+	{
+		std::cout << "ERROR::REPLAY: Failed to read replay file " << file << std::endl;
+		return false;
+	}
+
+	ByteReader reader(data.data(), data.size());
+	std::uint32_t magic = 0, version = 0;
+	reader.Get(magic);
+	reader.Get(version);
+	if (magic != MAGIC || version != VERSION)
+	{
+		std::cout << "ERROR::REPLAY: " << file << " is not a version " << VERSION << " replay" << std::endl;
+		return false;
+	}
+
+	reader.Get(this->Seed);
+	reader.Get(this->Level);
+	reader.Get(this->TickTime);
+	reader.Get(this->KeyframeInterval);
+	reader.GetVarint(this->TickCount);
+
+	std::uint64_t count = 0, previousTick = 0;
+	reader.GetVarint(count);
+	this->Inputs.clear();
+	for (std::uint64_t i = 0; i < count && !reader.Failed(); ++i)
+	{
+		std::uint64_t value = 0;
+		reader.GetVarint(value);
+		previousTick += value >> 3;
+		this->Inputs.push_back({ previousTick, static_cast<std::uint8_t>(value & 7) });
+	}
+
+	if (this->TickCount > data.size() / sizeof(std::uint32_t))
+	{
+		std::cout << "ERROR::REPLAY: " << file << " is truncated" << std::endl;
+		return false;
+	}
+	this->Hashes.resize(static_cast<std::size_t>(this->TickCount));
+	reader.GetBytes(this->Hashes.data(), this->Hashes.size() * sizeof(std::uint32_t));
+
+	reader.GetVarint(count);
+	this->Keyframes.clear();
+	for (std::uint64_t i = 0; i < count && !reader.Failed(); ++i)
+	{
+		Keyframe keyframe;
+		std::uint64_t size = 0;
+		reader.GetVarint(keyframe.Tick);
+		reader.GetVarint(keyframe.InputIndex);
+		reader.GetVarint(size);
+		const std::uint8_t *state = reader.Skip(static_cast<std::size_t>(size));
+		if (state)
+			keyframe.State.assign(state, state + size);
+		this->Keyframes.push_back(std::move(keyframe));
+	}
+
+	if (reader.Failed() || !reader.AtEnd() || this->Keyframes.empty() || this->KeyframeInterval == 0)
+	{
+		std::cout << "ERROR::REPLAY: " << file << " is corrupt" << std::endl;
+		return false;
+	}
+
+	// ReplayPlayer::Seek finds keyframes by dividing by the interval and
+	// resumes input at InputIndex, so both must hold for every keyframe
+	for (std::size_t i = 0; i < this->Keyframes.size(); ++i)
+	{
+		const Keyframe &keyframe = this->Keyframes[i];
+		if (keyframe.Tick != i * static_cast<std::uint64_t>(this->KeyframeInterval) || keyframe.InputIndex > this->Inputs.size())
+		{
+			std::cout << "ERROR::REPLAY: " << file << " has an invalid keyframe " << i << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+ReplayRecorder::ReplayRecorder(Replay &replay, std::uint64_t seed, float tickTime, std::uint32_t keyframeInterval)
+	: replay(replay), lastInput(0)
+{
+	this->replay = Replay();
+	this->replay.Seed = seed;
+	this->replay.TickTime = tickTime;
+	this->replay.KeyframeInterval = std::max(keyframeInterval, 1u);
+}
+
+void ReplayRecorder::BeginTick(const Simulation &sim, const SimInput &input)
+{
+	std::uint64_t tick = this->replay.TickCount;
+	if (tick == 0)
+		this->replay.Level = sim.currentLevel;
+
+	if (tick % this->replay.KeyframeInterval == 0)
+	{
+		Replay::Keyframe keyframe;
+		keyframe.Tick = tick;
+		keyframe.InputIndex = this->replay.Inputs.size();
+		sim.Save(keyframe.State);
+		this->replay.Keyframes.push_back(std::move(keyframe));
+	}
+
+	// Only changes are stored; the input starts out as all keys released
+	std::uint8_t bits = PackInput(input);
+	if (bits != this->lastInput)
+	{
+		this->replay.Inputs.push_back({ tick, bits });
+		this->lastInput = bits;
+	}
+}
+
+void ReplayRecorder::EndTick(Simulation &sim)
+{
+	this->replay.Hashes.push_back(FoldHash(sim.StateHash()));
+	++this->replay.TickCount;
+}
+
+ReplayPlayer::ReplayPlayer(const Replay &replay, Simulation &sim)
+	: replay(replay), sim(sim), tick(0), inputIndex(0)
+{
+}
+
+bool ReplayPlayer::Seek(std::uint64_t tick)
+{
+	if (tick > this->replay.TickCount || this->replay.Keyframes.empty())
+		return false;
+
+	// Keyframes are evenly spaced, so the closest one is found directly
+	std::size_t index = static_cast<std::size_t>(tick / this->replay.KeyframeInterval);
+	index = std::min(index, this->replay.Keyframes.size() - 1);
+	const Replay::Keyframe &keyframe = this->replay.Keyframes[index];
+	if (!this->sim.Restore(keyframe.State.data(), keyframe.State.size()))
+	{
+		std::cout << "ERROR::REPLAY: Failed to restore keyframe at tick " << keyframe.Tick << std::endl;
+		return false;
+	}
+
+	this->tick = keyframe.Tick;
+	this->inputIndex = static_cast<std::size_t>(keyframe.InputIndex);
+	this->input = this->inputIndex > 0
+		? UnpackInput(this->replay.Inputs[this->inputIndex - 1].Input)
+		: SimInput();
+
+	while (this->tick < tick)
+		this->Step();
+	return true;
+}
+
+bool ReplayPlayer::Step()
+{
+	if (this->Finished())
+		return false;
+
+	while (this->inputIndex < this->replay.Inputs.size() && this->replay.Inputs[this->inputIndex].Tick <= this->tick)
+		this->input = UnpackInput(this->replay.Inputs[this->inputIndex++].Input);
+
+	this->sim.ProcessInput(this->input, this->replay.TickTime);
+	this->sim.Update(this->replay.TickTime);
+
+	if (!this->Diverged && FoldHash(this->sim.StateHash()) != this->replay.Hashes[this->tick])
+	{
+		this->Diverged = true;
+		this->DivergedTick = this->tick;
+	}
+
+	++this->tick;
+	return true;
+}
@@ -0,0 +1,106 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Simulation.h"
+
+// Input of one tick packed into the low bits of a byte
+std::uint8_t PackInput(const SimInput &input);
+SimInput UnpackInput(std::uint8_t bits);
+
+// Recorded session: everything needed to re-simulate it bit for bit.
+//
+// File layout (.bkr, native byte order):
+//     header      magic, version, seed, level, tick time, keyframe interval
+//     varint      tick count
+//     varint      input change count, then per change
+//                 varint (ticks since previous change << 3 | input bits)
+//     uint32      state hash after every tick
+//     varint      keyframe count, then per keyframe
+//                 varint tick, varint input change index, varint size, state
+class Replay
+{
+public:
+	static const std::uint32_t MAGIC = 0x50524B42; // "BKRP"
+	static const std::uint32_t VERSION = 1;
+
+	// Input in effect from Tick on, until the next change
+	struct InputChange
+	{
+		std::uint64_t Tick;
+		std::uint8_t Input;
+	};
+
+	// Simulation::Save state at the start of Tick; InputIndex is the first
+	// input change at or after Tick
+	struct Keyframe
+	{
+		std::uint64_t Tick;
+		std::uint64_t InputIndex;
+		std::vector<std::uint8_t> State;
+	};
+
+	std::uint64_t Seed = 0;
+	std::uint32_t Level = 0;
+	float TickTime = 0.0f;
+	std::uint32_t KeyframeInterval = 0;
+	std::uint64_t TickCount = 0;
+
+	std::vector<InputChange> Inputs;
+	std::vector<std::uint32_t> Hashes;
+	std::vector<Keyframe> Keyframes;
+
+	bool Save(const char *file) const;
+	bool Load(const char *file);
+};
+
+// Appends the ticks of a running simulation to a Replay. Call BeginTick
+// with the tick's input before Simulation::ProcessInput and EndTick after
+// Simulation::Update.
+class ReplayRecorder
+{
+public:
+	ReplayRecorder(Replay &replay, std::uint64_t seed, float tickTime, std::uint32_t keyframeInterval);
+
+	void BeginTick(const Simulation &sim, const SimInput &input);
+	void EndTick(Simulation &sim);
+
+private:
+	Replay &replay;
+	std::uint8_t lastInput;
+};
+
+// Re-simulates a Replay as fast as possible, checking the state hash after
+// every tick. The Simulation must be Init()ed with the replay's seed, and
+// Seek (e.g. to tick 0) must succeed before the first Step.
+class ReplayPlayer
+{
+public:
+	ReplayPlayer(const Replay &replay, Simulation &sim);
+
+	// Jumps to the start of tick: restores the closest earlier keyframe and
+	// simulates the rest (at most one keyframe interval)
+	bool Seek(std::uint64_t tick);
+
+	// Simulates the next tick. Returns false once the replay is over
+	bool Step();
+
+	std::uint64_t Tick() const { return this->tick; }
+	bool Finished() const { return this->tick >= this->replay.TickCount; }
+
+	// First tick whose state hash didn't match the recording
+	bool Diverged = false;
+	std::uint64_t DivergedTick = 0;
+
+private:
+	const Replay &replay;
+	Simulation &sim;
+	std::uint64_t tick;
+	std::size_t inputIndex;
+	SimInput input;
+};
+
+#endif // !REPLAY_H
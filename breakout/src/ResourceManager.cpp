@@ -4,7 +4,9 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <set>
 
+#include "GLState.h"
 #include "3rdParty/stb_image.h"
 
 // Instantiate static variables
@@ -17,6 +19,14 @@ Shader ResourceManager::LoadShader(const char *vShaderFile, const char *fShaderF
 	return Shaders[name];
 }
 
+Shader ResourceManager::LoadShaderSource(const char *vShaderSource, const char *fShaderSource, const char *gShaderSource, std::string name)
+{
+	Shader shader;
+	shader.Compile(vShaderSource, fShaderSource, gShaderSource);
+	Shaders[name] = shader;
+	return shader;
+}
+
 Shader &ResourceManager::GetShader(std::string name)
 {
 	return Shaders[name];
@@ -33,15 +43,48 @@ Texture2D &ResourceManager::GetTexture(std::string name)
 	return Textures[name];
 }
 
+Texture2D ResourceManager::LoadTextureAtlas(const char *file, const AtlasRegion *regions, unsigned int count, std::string name)
+{
+	// Regions are padded with their own edge pixels; clamp the outer ones too
+	Texture2D atlas;
+	atlas.Internal_Format = GL_RGBA;
+	atlas.Image_Format = GL_RGBA;
+	atlas.Wrap_S = GL_CLAMP_TO_EDGE;
+	atlas.Wrap_T = GL_CLAMP_TO_EDGE;
+
+	int width = 0, height = 0, nrChannels;
+	unsigned char *data = stbi_load(file, &width, &height, &nrChannels, 4);
+	if (!data)
+		std::cout << "ERROR::TEXTURE: Failed to load atlas " << file << std::endl;
+	atlas.Generate(width, height, data);
+	stbi_image_free(data);
+	Textures[name] = atlas;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const AtlasRegion &region = regions[i];
+		Texture2D texture = atlas;
+		texture.Width = region.Width;
+		texture.Height = region.Height;
+		if (data)
+			texture.Region = glm::vec4(region.X / static_cast<float>(width), region.Y / static_cast<float>(height),
+				region.Width / static_cast<float>(width), region.Height / static_cast<float>(height));
+		Textures[region.Name] = texture;
+	}
+	return atlas;
+}
+
 void ResourceManager::Clear()
 {
 	// Properly delete all shaders
 	for (auto iter : Shaders)
-		glDeleteProgram(iter.second.ID);
+		GLState::DeleteProgram(iter.second.ID);
 	
-	// Properly delete all textures
+	// Properly delete all textures, once for all regions of an atlas
+	std::set<unsigned int> textures;
 	for (auto iter : Textures)
-		glDeleteTextures(1, &iter.second.ID);
+		if (textures.insert(iter.second.ID).second)
+			GLState::DeleteTextures(1, &iter.second.ID);
 }
 
 Shader ResourceManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile)
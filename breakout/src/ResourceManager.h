@@ -24,15 +24,24 @@ public:
 	// shader's source code. If gShader is not nullptr, it also loads a geometry shader
 	static Shader LoadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
 
+	// Generates a shader program from vertex, fragment (and geometry) source code
+	// already in memory, e.g. shaders embedded in the binary (see EmbeddedShaders.h)
+	static Shader LoadShaderSource(const char *vShaderSource, const char *fShaderSource, const char *gShaderSource, std::string name);
+
 	// Retrieves a stored Shader
 	static Shader &GetShader(std::string name);
 
 	// Loads (and generates) a texture from file
 	static Texture2D LoadTexture(const char *file, bool alpha, std::string name);
 
-	// Retrieves a stored texture
+	// Retrieves a stored texture: a whole texture, or one image of an atlas
 	static Texture2D &GetTexture(std::string name);
 
+	// Loads (and generates) a texture atlas made by atlas_packer, stored as
+	// name, and stores a texture handle for each of its regions under the
+	// region's name (see Texture2D::Region)
+	static Texture2D LoadTextureAtlas(const char *file, const AtlasRegion *regions, unsigned int count, std::string name);
+
 	// Properly de-allocates all loaded resources
 	static void Clear();
 private:
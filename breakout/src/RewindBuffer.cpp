@@ -0,0 +1,118 @@
+#include "RewindBuffer.h"
+
+#include <algorithm>
+
+#include "ByteStream.h"
+
+RewindBuffer::RewindBuffer(std::size_t capacity)
+	: deltas(std::max<std::size_t>(capacity, 2) - 1), head(0), count(0)
+{
+}
+
+void RewindBuffer::Push(const std::vector<std::uint8_t> &state)
+{
+	if (this->count > 0)
+	{
+		this->head = (this->head + 1) % this->deltas.size();
+		encode(this->newest, state, this->deltas[this->head]);
+	}
+
+	this->newest = state;
+	this->count = std::min(this->count + 1, this->deltas.size() + 1);
+}
+
+bool RewindBuffer::Rewind(std::size_t ticks, std::vector<std::uint8_t> &state)
+{
+	if (ticks >= this->count)
+		return false;
+
+	for (std::size_t i = 0; i < ticks; ++i)
+	{
+		apply(this->deltas[this->head], this->newest);
+		this->head = (this->head + this->deltas.size() - 1) % this->deltas.size();
+		--this->count;
+	}
+
+	state = this->newest;
+	return true;
+}
+
+void RewindBuffer::Clear()
+{
+	this->head = 0;
+	this->count = 0;
+	this->newest.clear();
+}
+
+std::size_t RewindBuffer::Bytes() const
+{
+	std::size_t bytes = this->newest.size();
+	for (std::size_t i = 0; i + 1 < this->count; ++i)
+		bytes += this->deltas[(this->head + this->deltas.size() - i) % this->deltas.size()].Runs.size();
+	return bytes;
+}
+
+void RewindBuffer::encode(const std::vector<std::uint8_t> &older, const std::vector<std::uint8_t> &newer, Delta &delta)
+{
+	// Bytes past the end of the shorter state count as zero
+	std::size_t size = std::max(older.size(), newer.size());
+	auto difference = [&](std::size_t i) -> std::uint8_t {
+		return (i < older.size() ? older[i] : 0) ^ (i < newer.size() ? newer[i] : 0);
+	};
+
+	delta.PreviousSize = static_cast<std::uint32_t>(older.size());
+	delta.Runs.clear();
+	ByteWriter writer(delta.Runs);
+
+	std::size_t i = 0;
+	while (i < size)
+	{
+		std::size_t zeroStart = i;
+		while (i < size && difference(i) == 0)
+			++i;
+		if (i == size)
+			break;
+
+		// Literal run, ended by a gap of unchanged bytes worth encoding as a run
+		std::size_t literalStart = i, literalEnd = i;
+		while (i < size)
+		{
+			if (difference(i) != 0)
+				literalEnd = ++i;
+			else if (i - literalEnd < 3)
+				++i;
+			else
+				break;
+		}
+		i = literalEnd;
+
+		writer.PutVarint(literalStart - zeroStart);
+		writer.PutVarint(literalEnd - literalStart);
+		for (std::size_t j = literalStart; j < literalEnd; ++j)
+			delta.Runs.push_back(difference(j));
+	}
+}
+
+void RewindBuffer::apply(const Delta &delta, std::vector<std::uint8_t> &state)
+{
+	state.resize(std::max<std::size_t>(state.size(), delta.PreviousSize), 0);
+
+	ByteReader reader(delta.Runs.data(), delta.Runs.size());
+	std::size_t position = 0;
+	while (!reader.AtEnd())
+	{
+		std::uint64_t zeros, literals;
+		if (!reader.GetVarint(zeros) || !reader.GetVarint(literals))
+			break;
+		position += static_cast<std::size_t>(zeros);
+
+		const std::uint8_t *bytes = reader.Skip(static_cast<std::size_t>(literals));
+		if (!bytes || position + literals > state.size())
+			break;
+		for (std::size_t j = 0; j < literals; ++j)
+			state[position + j] ^= bytes[j];
+		position += static_cast<std::size_t>(literals);
+	}
+
+	state.resize(delta.PreviousSize);
+}
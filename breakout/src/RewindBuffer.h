@@ -0,0 +1,55 @@
+#ifndef REWIND_BUFFER_H
+#define REWIND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-length history of Simulation::Save states for rewinding.
+//
+// Only the newest state is kept whole. Every older one is stored as the XOR
+// of it with its successor, run-length encoded; consecutive ticks differ in a
+// few dozen bytes (moved objects, a destroyed brick bit), so a slot is
+// usually tiny. The level layouts aren't part of the saved state at all.
+// Slots are reused once the history is full, so the steady state doesn't
+// allocate.
+class RewindBuffer
+{
+public:
+	// Keeps up to capacity states (e.g. seconds * tick rate)
+	explicit RewindBuffer(std::size_t capacity);
+
+	// Appends the state of the tick that just finished
+	void Push(const std::vector<std::uint8_t> &state);
+
+	// Drops the newest ticks states and writes the state that is then the
+	// newest to state. Returns false (and leaves state alone) if fewer than
+	// ticks + 1 states are stored
+	bool Rewind(std::size_t ticks, std::vector<std::uint8_t> &state);
+
+	void Clear();
+
+	// Number of states held (including the newest, full one)
+	std::size_t Count() const { return this->count; }
+
+	// Bytes used by the encoded deltas and the newest state
+	std::size_t Bytes() const;
+
+private:
+	struct Delta
+	{
+		std::uint32_t PreviousSize;	// size of the older state
+		std::vector<std::uint8_t> Runs;	// varint zero run, varint literal count, literals...
+	};
+
+	std::vector<Delta> deltas;	// ring; deltas[head] is the newest
+	std::size_t head;
+	std::size_t count;
+	std::vector<std::uint8_t> newest;
+	std::vector<std::uint8_t> scratch;
+
+	static void encode(const std::vector<std::uint8_t> &older, const std::vector<std::uint8_t> &newer, Delta &delta);
+	static void apply(const Delta &delta, std::vector<std::uint8_t> &state);
+};
+
+#endif // !REWIND_BUFFER_H
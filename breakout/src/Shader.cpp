@@ -1,17 +1,32 @@
 #include "Shader.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "GLState.h"
+#include "ProgramCache.h"
+
 Shader &Shader::Use() 
 {
-    glUseProgram(this->ID);
+    GLState::UseProgram(this->ID);
     return *this;
 }
 
 void Shader::Compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) 
 {
+    // A binary of the same program from an earlier run saves compiling and linking
+    std::string sources = std::string(vertexSource) + '\0' + fragmentSource + '\0' + (geometrySource ? geometrySource : "");
+    std::uint64_t key = ProgramCache::Key(sources);
+    this->ID = ProgramCache::Load(key);
+    if (this->ID != 0)
+    {
+        this->introspect();
+        return;
+    }
+
     unsigned int sVertex, sFragment, gShader;
 
     // Vertex Shader
@@ -41,8 +56,11 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
     glAttachShader(this->ID, sFragment);
     if (geometrySource != nullptr)
         glAttachShader(this->ID, gShader);
+    ProgramCache::PrepareLink(this->ID);
     glLinkProgram(this->ID);
     checkCompileErrors(this->ID, "PROGRAM");
+    ProgramCache::Store(key, this->ID);
+    this->introspect();
 
     // Delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(sVertex);
@@ -51,67 +69,193 @@ void Shader::Compile(const char* vertexSource, const char* fragmentSource, const
         glDeleteShader(gShader);
 }
 
+bool Shader::CompileFeedback(const char *vertexSource, const char *const *varyings, int varyingCount)
+{
+    // The captured outputs are part of the program, so they're part of the key
+    std::string sources = std::string(vertexSource) + '\0' + "feedback";
+    for (int i = 0; i < varyingCount; ++i)
+    {
+        sources += '\0';
+        sources += varyings[i];
+    }
+    std::uint64_t key = ProgramCache::Key(sources);
+    this->ID = ProgramCache::Load(key);
+    if (this->ID != 0)
+    {
+        this->introspect();
+        return true;
+    }
+
+    unsigned int sVertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(sVertex, 1, &vertexSource, NULL);
+    glCompileShader(sVertex);
+    checkCompileErrors(sVertex, "VERTEX");
+
+    // The captured outputs have to be named before linking
+    this->ID = glCreateProgram();
+    glAttachShader(this->ID, sVertex);
+    glTransformFeedbackVaryings(this->ID, varyingCount, varyings, GL_INTERLEAVED_ATTRIBS);
+    ProgramCache::PrepareLink(this->ID);
+    glLinkProgram(this->ID);
+    checkCompileErrors(this->ID, "PROGRAM");
+    ProgramCache::Store(key, this->ID);
+    this->introspect();
+    glDeleteShader(sVertex);
+
+    int success;
+    glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+    return success != 0;
+}
+
 void Shader::SetFloat(const char *name, float value, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    glUniform1f(this->Uniform(name), value);
 }
 
 void Shader::SetInteger(const char *name, int value, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
+    glUniform1i(this->Uniform(name), value);
 }
 
 void Shader::SetVector2f(const char *name, float x, float y, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    glUniform2f(this->Uniform(name), x, y);
 }
 
 void Shader::SetVector2f(const char *name, const glm::vec2 &value, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    glUniform2f(this->Uniform(name), value.x, value.y);
 }
 
 void Shader::SetVector3f(const char *name, float x, float y, float z, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    glUniform3f(this->Uniform(name), x, y, z);
 }
 
 void Shader::SetVector3f(const char *name, const glm::vec3 &value, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    glUniform3f(this->Uniform(name), value.x, value.y, value.z);
 }
 
 void Shader::SetVector4f(const char *name, float x, float y, float z, float w, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    glUniform4f(this->Uniform(name), x, y, z, w);
 }
 
 void Shader::SetVector4f(const char *name, const glm::vec4 &value, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    glUniform4f(this->Uniform(name), value.x, value.y, value.z, value.w);
 }
 
 void Shader::SetMatrix4(const char *name, const glm::mat4 &matrix, bool useShader) 
 {
     if (useShader)
         this->Use();
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+    glUniformMatrix4fv(this->Uniform(name), 1, false, glm::value_ptr(matrix));
+}
+
+int Shader::Uniform(const char *name) const
+{
+    auto it = std::lower_bound(this->uniforms.begin(), this->uniforms.end(), name,
+        [](const std::pair<std::string, int> &uniform, const char *name) { return std::strcmp(uniform.first.c_str(), name) < 0; });
+    return it != this->uniforms.end() && it->first == name ? it->second : -1;
+}
+
+void Shader::SetFloat(int location, float value, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniform1f(location, value);
+}
+
+void Shader::SetInteger(int location, int value, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniform1i(location, value);
+}
+
+void Shader::SetVector2f(int location, const glm::vec2 &value, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniform2f(location, value.x, value.y);
+}
+
+void Shader::SetVector3f(int location, const glm::vec3 &value, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniform3f(location, value.x, value.y, value.z);
+}
+
+void Shader::SetVector4f(int location, const glm::vec4 &value, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniform4f(location, value.x, value.y, value.z, value.w);
+}
+
+void Shader::SetVector4f(int location, const glm::vec4 *values, int count, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniform4fv(location, count, glm::value_ptr(values[0]));
+}
+
+void Shader::SetMatrix4(int location, const glm::mat4 &matrix, bool useShader)
+{
+    if (useShader)
+        this->Use();
+    glUniformMatrix4fv(location, 1, false, glm::value_ptr(matrix));
+}
+
+void Shader::introspect()
+{
+    this->uniforms.clear();
+    int count = 0, maxLength = 0;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> name(maxLength + 1);
+    for (int i = 0; i < count; ++i)
+    {
+        GLsizei length;
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(this->ID, i, static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+
+        // Members of uniform blocks have no location
+        int location = glGetUniformLocation(this->ID, name.data());
+        if (location < 0)
+            continue;
+
+        // Arrays are reported as "name[0]"; glGetUniformLocation accepts both
+        std::string uniform(name.data(), length);
+        if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+            uniform.erase(uniform.size() - 3);
+        this->uniforms.emplace_back(uniform, location);
+    }
+    std::sort(this->uniforms.begin(), this->uniforms.end());
+
+    unsigned int frameData = glGetUniformBlockIndex(this->ID, "FrameData");
+    if (frameData != GL_INVALID_INDEX)
+        glUniformBlockBinding(this->ID, frameData, FRAME_DATA_BINDING);
 }
 
 void Shader::checkCompileErrors(unsigned int object, std::string type) 
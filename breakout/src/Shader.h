@@ -3,13 +3,24 @@
 
 #include <glm/glm.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 // General purpose shader object. Compiles from file, generates
 // compile/link-time error messages and hosts several utility
 // functions for easy management.
+//
+// After linking, the active uniforms are read into a table once, so setting
+// a uniform by name doesn't ask the driver. Hot paths can resolve a location
+// up front (Uniform) and use the Set* overloads that take it. Programs that
+// declare the FrameData uniform block get it bound to FRAME_DATA_BINDING
+// (see FrameUniforms). Linked programs are cached on disk by ProgramCache.
 class Shader 
 {
 public:
+	// Binding point of the FrameData uniform block shared by all programs
+	static const unsigned int FRAME_DATA_BINDING = 0;
+
 	// State
 	unsigned int ID;
 
@@ -22,6 +33,15 @@ public:
 	// Note: geometry source code is optional
 	void Compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr);
 
+	// Compiles a vertex-only program whose outputs are captured with
+	// transform feedback, interleaved in the order of varyings.
+	// Returns false if it fails to link
+	bool CompileFeedback(const char *vertexSource, const char *const *varyings, int varyingCount);
+
+	// Location of the active uniform name (arrays by their plain name),
+	// or -1 if the program has none
+	int Uniform(const char *name) const;
+
 	// Utility functions
 	void SetFloat(const char *name, float value, bool useShader = false);
 	void SetInteger(const char *name, int value, bool useShader = false);
@@ -32,7 +52,23 @@ public:
 	void SetVector4f(const char *name, float x, float y, float z, float w, bool useShader = false);
 	void SetVector4f(const char *name, const glm::vec4 &value, bool useShader = false);
 	void SetMatrix4(const char *name, const glm::mat4 &matrix, bool useShader = false);
+
+	// The same, for a location from Uniform
+	void SetFloat(int location, float value, bool useShader = false);
+	void SetInteger(int location, int value, bool useShader = false);
+	void SetVector2f(int location, const glm::vec2 &value, bool useShader = false);
+	void SetVector3f(int location, const glm::vec3 &value, bool useShader = false);
+	void SetVector4f(int location, const glm::vec4 &value, bool useShader = false);
+	// Sets count elements of a vec4 array uniform, starting at location
+	void SetVector4f(int location, const glm::vec4 *values, int count, bool useShader = false);
+	void SetMatrix4(int location, const glm::mat4 &matrix, bool useShader = false);
 private:
+	// Active uniforms (name, location), sorted by name
+	std::vector<std::pair<std::string, int>> uniforms;
+
+	// Builds the uniform table and binds the FrameData block after linking
+	void introspect();
+
 	// Checks if compilation or linking failed and if so, print the error logs
 	void checkCompileErrors(unsigned int object, std::string type);
 };
@@ -0,0 +1,585 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Collision.h"
+#include "ParticlePool.h"
+#include "Replay.h"
+#include "RewindBuffer.h"
+#include "Simulation.h"
+
+// Headless driver for the Simulation (breakout_sim target).
+// Runs a fixed number of ticks with no window, GL context or sound device
+// and reports throughput, e.g. for soak and regression runs:
+//
+//     breakout_sim [ticks] [tick rate in Hz] [--balls count] [--ball-radius radius] [--seed seed] [--level file] [--record file]
+//
+// The paddle is steered by a trivial autopilot that tracks the first ball.
+// --balls adds that many launched balls on top of it, to measure how the
+// ball - brick and ball - ball collision passes scale. Runs with the same
+// seed and arguments are identical. --level plays a .lvl or .lvlb file
+// (e.g. a large one from level_compiler --generate) instead of the first
+// built-in level. --record saves the run as a replay; replays only know the
+// built-in levels, so it can't be combined with --level.
+//
+//     breakout_sim --replay file [--seek tick]
+//
+// Re-simulates a recorded replay (from breakout --record or breakout_sim
+// --record) as fast as possible, optionally starting from a given tick, and
+// reports the first tick whose state hash differs from the recording.
+//
+//     breakout_sim --collision-bench [bricks]
+//
+// Times one ball against every brick of a large grid with the per-object
+// Simulation::CheckCollision path, the scalar batch kernel and the SIMD one.
+//
+//     breakout_sim --particle-bench [particles] [threads]
+//
+// Times ParticlePool::Update on a full pool with the scalar kernel, the SIMD
+// one, and the SIMD one split across threads (default: all hardware threads).
+//
+//     breakout_sim --self-check
+//
+// Checks that the SIMD circle - box kernel agrees bit for bit with the scalar
+// one, that a ball starting a tick inside a brick is pushed out of it, that a recorded replay survives a save / load round trip and plays
+// back to the recorded state from any seek position, and that the rewind
+// buffer's delta encoding gives back every state pushed into it. Prints what
+// was compared and exits non-zero on any mismatch, so it can run unattended,
+// e.g. in CI.
+
+const unsigned int SCREEN_WIDTH = 800;
+const unsigned int SCREEN_HEIGHT = 600;
+
+SimInput Autopilot(const Simulation &sim)
+{
+	SimInput input;
+	float paddleCenter = sim.Player.Position.x + sim.Player.Size.x / 2.0f;
+	float ballCenter = sim.Balls[0].Position.x + sim.Balls[0].Radius;
+
+	input.Left = ballCenter < paddleCenter - 10.0f;
+	input.Right = ballCenter > paddleCenter + 10.0f;
+	input.Launch = true;
+	return input;
+}
+
+// Runs fn once per ball position and returns the average time per brick test in ns
+template <typename Function>
+double TimePerBrick(const std::vector<glm::vec2> &balls, size_t bricks, unsigned long long &hits, Function fn)
+{
+	hits = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const glm::vec2 &ball : balls)
+		hits += fn(ball);
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / (balls.size() * bricks);
+}
+
+int CollisionBenchmark(unsigned int brickCount)
+{
+	// Lay the bricks out on a square grid covering the screen
+	unsigned int columns = 1;
+	while (columns * columns < brickCount)
+		++columns;
+	glm::vec2 brickSize(SCREEN_WIDTH / static_cast<float>(columns), SCREEN_HEIGHT / static_cast<float>(columns));
+
+	Simulation sim(SCREEN_WIDTH, SCREEN_HEIGHT);
+	std::vector<GameObject> objects;
+	std::vector<glm::vec2> positions;
+	for (unsigned int i = 0; i < brickCount; ++i)
+	{
+		glm::vec2 position(brickSize.x * (i % columns), brickSize.y * (i / columns));
+		objects.push_back(GameObject(position, brickSize));
+		positions.push_back(position);
+	}
+
+	std::vector<glm::vec2> balls;
+	for (unsigned int i = 0; i < 1000; ++i)
+		balls.push_back(glm::vec2((i * 7919) % SCREEN_WIDTH, (i * 104729) % SCREEN_HEIGHT));
+
+	BallObject ball(glm::vec2(0.0f), sim.BALL_RADIUS, glm::vec2(0.0f));
+	std::vector<std::uint32_t> mask((brickCount + 31) / 32);
+	std::vector<glm::vec2> differences(brickCount);
+	unsigned long long objectHits, scalarHits, simdHits;
+
+	double object = TimePerBrick(balls, brickCount, objectHits, [&](glm::vec2 position) {
+		ball.Position = position;
+		unsigned int hits = 0;
+		for (GameObject &brick : objects)
+			hits += sim.CheckCollision(ball, brick);
+		return hits;
+	});
+	double scalar = TimePerBrick(balls, brickCount, scalarHits, [&](glm::vec2 position) {
+		return CircleAABBBatchScalar(position + ball.Radius, ball.Radius, positions.data(), brickSize,
+			brickCount, mask.data(), differences.data());
+	});
+	double simd = TimePerBrick(balls, brickCount, simdHits, [&](glm::vec2 position) {
+		return CircleAABBBatch(position + ball.Radius, ball.Radius, positions.data(), brickSize,
+			brickCount, mask.data(), differences.data());
+	});
+
+	std::cout << "bricks:         " << brickCount << std::endl;
+	std::cout << "CheckCollision: " << object << " ns/brick (" << objectHits << " hits)" << std::endl;
+	std::cout << "scalar batch:   " << scalar << " ns/brick (" << scalarHits << " hits)" << std::endl;
+	std::cout << "SIMD batch:     " << simd << " ns/brick (" << simdHits << " hits)" << std::endl;
+
+	return objectHits == scalarHits && scalarHits == simdHits ? 0 : -1;
+}
+
+int ParticleBenchmark(unsigned int particleCount, unsigned int threads)
+{
+	// Long-lived particles, so the pool stays full for the whole run
+	ParticlePool pool(particleCount);
+	ParticleEmitter emitter;
+	emitter.Life = 1000.0f;
+	emitter.Jitter = 400.0f;
+	emitter.Speed = 100.0f;
+	pool.Burst(emitter, particleCount, glm::vec2(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f), glm::vec2(0.0f));
+
+	const unsigned int updates = 200;
+	const float dt = 1.0f / 240.0f;
+	auto time = [&](auto fn) {
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < updates; ++i)
+			fn();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count() / updates;
+	};
+
+	double scalar = time([&]() {
+		IntegrateParticlesScalar(pool.PositionX.data(), pool.PositionY.data(), pool.VelocityX.data(), pool.VelocityY.data(),
+			0, pool.Count(), dt);
+	});
+	double simd = time([&]() { pool.Update(dt); });
+	pool.SetThreads(threads);
+	double threaded = time([&]() { pool.Update(dt); });
+
+	std::cout << "particles:        " << pool.Count() << std::endl;
+	std::cout << "scalar kernel:    " << scalar << " ms/update" << std::endl;
+	std::cout << "SIMD Update:      " << simd << " ms/update" << std::endl;
+	std::cout << "SIMD, " << threads << " threads: " << threaded << " ms/update" << std::endl;
+
+	return pool.Count() == particleCount ? 0 : -1;
+}
+
+// Keyframe every 10 seconds at the default tick rate
+const std::uint32_t REPLAY_KEYFRAME_INTERVAL = 2400;
+
+int PlayReplay(const char *file, std::uint64_t seekTick)
+{
+	Replay replay;
+	if (!replay.Load(file))
+		return -1;
+
+	Simulation sim(SCREEN_WIDTH, SCREEN_HEIGHT, replay.Seed);
+	sim.Init();
+
+	auto start = std::chrono::steady_clock::now();
+	ReplayPlayer player(replay, sim);
+	if (!player.Seek(seekTick))
+	{
+		std::cout << "ERROR::REPLAY: Can't seek to tick " << seekTick << " of " << replay.TickCount << std::endl;
+		return -1;
+	}
+	auto seeked = std::chrono::steady_clock::now();
+	while (player.Step())
+		;
+	auto end = std::chrono::steady_clock::now();
+
+	double seekMs = std::chrono::duration<double, std::milli>(seeked - start).count();
+	double elapsedMs = std::chrono::duration<double, std::milli>(end - seeked).count();
+	std::uint64_t ticks = replay.TickCount - seekTick;
+	std::cout << "replay:           " << replay.TickCount << " ticks, " << replay.Inputs.size() << " input changes, "
+		<< replay.Keyframes.size() << " keyframes" << std::endl;
+	std::cout << "seek:             tick " << seekTick << " in " << seekMs << " ms" << std::endl;
+	std::cout << "elapsed:          " << elapsedMs << " ms" << std::endl;
+	std::cout << "ticks per ms:     " << (elapsedMs > 0.0 ? ticks / elapsedMs : 0.0) << std::endl;
+	if (player.Diverged)
+	{
+		std::cout << "DIVERGED at tick " << player.DivergedTick << std::endl;
+		return 1;
+	}
+	std::cout << "state hashes:     all match" << std::endl;
+	return 0;
+}
+
+// Compares CircleAABBBatch with CircleAABBBatchScalar on random boxes, with
+// counts that leave every possible SIMD tail, and on circles that touch a
+// box edge, where a different operation order would show first
+bool CheckCollisionKernels()
+{
+	Random random(Random::DEFAULT_SEED);
+	const unsigned int counts[] = { 1, 7, 33, 1003 };
+	unsigned int circles = 0, mismatches = 0;
+	for (unsigned int count : counts)
+	{
+		glm::vec2 boxSize(random.Range(4.0f, 80.0f), random.Range(4.0f, 40.0f));
+		std::vector<glm::vec2> boxMins(count);
+		for (glm::vec2 &boxMin : boxMins)
+			boxMin = glm::vec2(random.Range(0.0f, SCREEN_WIDTH), random.Range(0.0f, SCREEN_HEIGHT));
+
+		std::vector<std::uint32_t> scalarMask((count + 31) / 32), simdMask(scalarMask.size());
+		std::vector<glm::vec2> scalarDifferences(count), simdDifferences(count);
+		for (unsigned int i = 0; i < 1000; ++i, ++circles)
+		{
+			float radius = random.Range(1.0f, 40.0f);
+			glm::vec2 center(random.Range(-50.0f, SCREEN_WIDTH + 50.0f), random.Range(-50.0f, SCREEN_HEIGHT + 50.0f));
+			if (i % 2)
+				center = boxMins[random.Below(count)] + glm::vec2(-radius, random.Range(0.0f, boxSize.y));
+
+			unsigned int scalarHits = CircleAABBBatchScalar(center, radius, boxMins.data(), boxSize, count,
+				scalarMask.data(), scalarDifferences.data());
+			unsigned int simdHits = CircleAABBBatch(center, radius, boxMins.data(), boxSize, count,
+				simdMask.data(), simdDifferences.data());
+			if (scalarHits != simdHits || scalarMask != simdMask || scalarDifferences != simdDifferences)
+				++mismatches;
+		}
+	}
+
+	std::cout << "collision kernels: " << circles << " circles, " << mismatches << " SIMD / scalar mismatches" << std::endl;
+	return mismatches == 0;
+}
+
+bool SameReplay(const Replay &a, const Replay &b)
+{
+	if (a.Seed != b.Seed || a.Level != b.Level || a.TickTime != b.TickTime || a.KeyframeInterval != b.KeyframeInterval
+		|| a.TickCount != b.TickCount || a.Hashes != b.Hashes
+		|| a.Inputs.size() != b.Inputs.size() || a.Keyframes.size() != b.Keyframes.size())
+		return false;
+	for (std::size_t i = 0; i < a.Inputs.size(); ++i)
+		if (a.Inputs[i].Tick != b.Inputs[i].Tick || a.Inputs[i].Input != b.Inputs[i].Input)
+			return false;
+	for (std::size_t i = 0; i < a.Keyframes.size(); ++i)
+		if (a.Keyframes[i].Tick != b.Keyframes[i].Tick || a.Keyframes[i].InputIndex != b.Keyframes[i].InputIndex
+			|| a.Keyframes[i].State != b.Keyframes[i].State)
+			return false;
+	return true;
+}
+
+// Records a multi-ball run, saves and loads it, then plays it back from the
+// start, from keyframes and from between keyframes, expecting every state
+// hash and the final state to match. Also makes sure Load rejects keyframes
+// Seek couldn't use
+bool CheckReplay()
+{
+	const std::uint64_t seed = 12345;
+	const std::uint64_t ticks = 6000;
+	const std::uint32_t keyframeInterval = 500;
+	const float dt = 1.0f / 240.0f;
+	std::string file = (std::filesystem::temp_directory_path() / "breakout_sim_self_check.bkr").string();
+
+	// Extra balls, so keyframes hold pooled balls; keyframe 0 captures them
+	Simulation recorded(SCREEN_WIDTH, SCREEN_HEIGHT, seed);
+	recorded.Init();
+	recorded.SpawnBalls(8, recorded.BALL_RADIUS);
+	Replay replay;
+	ReplayRecorder recorder(replay, seed, dt, keyframeInterval);
+	for (std::uint64_t i = 0; i < ticks; ++i)
+	{
+		SimInput input = Autopilot(recorded);
+		recorder.BeginTick(recorded, input);
+		recorded.ProcessInput(input, dt);
+		recorded.Update(dt);
+		recorder.EndTick(recorded);
+	}
+	std::uint64_t finalHash = recorded.StateHash();
+
+	Replay loaded;
+	bool passed = replay.Save(file.c_str()) && loaded.Load(file.c_str()) && SameReplay(replay, loaded);
+	std::cout << "replay round trip: " << replay.Inputs.size() << " input changes, " << replay.Keyframes.size()
+		<< " keyframes" << (passed ? ", identical" : ", MISMATCH") << std::endl;
+
+	const std::uint64_t seekTicks[] = { 0, 1, keyframeInterval, 2 * keyframeInterval + 123, ticks - 1, ticks };
+	for (std::uint64_t seekTick : seekTicks)
+	{
+		Simulation sim(SCREEN_WIDTH, SCREEN_HEIGHT, loaded.Seed);
+		sim.Init();
+		ReplayPlayer player(loaded, sim);
+		bool matches = player.Seek(seekTick);
+		while (matches && player.Step())
+			;
+		matches = matches && !player.Diverged && sim.StateHash() == finalHash;
+		std::cout << "replay seek:       tick " << seekTick << (matches ? ", matches" : ", MISMATCH") << std::endl;
+		passed = passed && matches;
+	}
+
+	// Replays Seek would divide by zero with or read inputs past the end of
+	std::cout << "(two ERROR::REPLAY lines expected)" << std::endl;
+	Replay broken = replay;
+	broken.KeyframeInterval = 0;
+	bool rejected = broken.Save(file.c_str()) && !loaded.Load(file.c_str());
+	broken = replay;
+	broken.Keyframes.back().InputIndex = broken.Inputs.size() + 1;
+	rejected = rejected && broken.Save(file.c_str()) && !loaded.Load(file.c_str());
+	std::cout << "replay validation: " << (rejected ? "bad keyframes rejected" : "BAD KEYFRAMES ACCEPTED") << std::endl;
+
+	std::filesystem::remove(file);
+	return passed && rejected;
+}
+
+// Pushes states into a RewindBuffer and rewinds through them, comparing
+// every state that comes back with the one pushed. First game states, over
+// more ticks than the buffer holds, then random states that grow, shrink,
+// empty out and change in runs long enough to need multi-byte varints
+bool CheckRewind()
+{
+	const std::size_t capacity = 1000;
+	const float dt = 1.0f / 240.0f;
+	unsigned int states = 0, mismatches = 0;
+	std::vector<std::uint8_t> state;
+	auto rewindAll = [&](RewindBuffer &buffer, const std::vector<std::vector<std::uint8_t>> &history) {
+		// Alternating step lengths, down to the oldest state held
+		std::size_t newest = history.size() - 1, oldest = history.size() - buffer.Count();
+		for (std::size_t step = 0; newest > oldest; ++step)
+		{
+			std::size_t ticks = std::min<std::size_t>(step % 2 ? 1 : 37, newest - oldest);
+			newest -= ticks;
+			++states;
+			if (!buffer.Rewind(ticks, state) || state != history[newest])
+				++mismatches;
+		}
+		if (buffer.Count() != 1 || buffer.Rewind(1, state))
+			++mismatches;
+	};
+
+	Simulation sim(SCREEN_WIDTH, SCREEN_HEIGHT);
+	sim.Init();
+	sim.SpawnBalls(8, sim.BALL_RADIUS);
+	RewindBuffer gameBuffer(capacity);
+	std::vector<std::vector<std::uint8_t>> gameHistory;
+	for (std::size_t i = 0; i < 3 * capacity; ++i)
+	{
+		SimInput input = Autopilot(sim);
+		sim.ProcessInput(input, dt);
+		sim.Update(dt);
+		sim.Save(state);
+		gameBuffer.Push(state);
+		gameHistory.push_back(state);
+	}
+	std::size_t gameBytes = gameBuffer.Bytes();
+	rewindAll(gameBuffer, gameHistory);
+
+	Random random(Random::DEFAULT_SEED);
+	RewindBuffer randomBuffer(capacity);
+	std::vector<std::vector<std::uint8_t>> randomHistory;
+	state.clear();
+	for (std::size_t i = 0; i < capacity; ++i)
+	{
+		if (random.Below(8) == 0)
+			state.resize(random.Below(2000), static_cast<std::uint8_t>(random.Next()));
+		for (std::uint32_t run = random.Below(4); run > 0 && !state.empty(); --run)
+		{
+			std::size_t start = random.Below(static_cast<std::uint32_t>(state.size()));
+			std::size_t length = std::min<std::size_t>(random.Below(300) + 1, state.size() - start);
+			for (std::size_t j = start; j < start + length; j += 1 + random.Below(4))
+				state[j] = static_cast<std::uint8_t>(random.Next());
+		}
+		randomBuffer.Push(state);
+		randomHistory.push_back(state);
+	}
+	rewindAll(randomBuffer, randomHistory);
+
+	std::cout << "rewind buffer:     " << states << " states rewound (" << gameBytes / 1024 << " KB for "
+		<< capacity << " game ticks), " << mismatches << " mismatches" << std::endl;
+	return mismatches == 0;
+}
+
+// Starts a ball overlapping a brick, as separating two balls can leave it,
+// and runs one tick. The ball must end up outside the brick, having hit it
+// (destroyed it, or bounced off a solid one) if it was moving into it
+bool CheckBrickOverlaps()
+{
+	struct Case
+	{
+		const char *Name;
+		bool Solid;
+		glm::vec2 Center;	// relative to the brick's bottom right corner
+		glm::vec2 Velocity;
+		bool Hits;
+	};
+	const Case cases[] = {
+		{ "center inside, solid", true, glm::vec2(-100.0f, -3.0f), glm::vec2(0.0f, -300.0f), true },
+		{ "center inside, breakable", false, glm::vec2(-100.0f, -3.0f), glm::vec2(0.0f, -300.0f), true },
+		{ "over a corner, breakable", false, glm::vec2(4.0f, 4.0f), glm::vec2(-300.0f, -300.0f), true },
+		{ "leaving, solid", true, glm::vec2(-100.0f, 5.0f), glm::vec2(0.0f, 300.0f), false },
+	};
+
+	unsigned int failures = 0;
+	for (const Case &test : cases)
+	{
+		// One brick in the top half of the screen, nothing else
+		Simulation sim(SCREEN_WIDTH, SCREEN_HEIGHT);
+		sim.Init();
+		GameLevel &level = sim.Levels[sim.currentLevel];
+		const std::uint8_t tile = test.Solid ? 1 : 2;
+		level.LoadTiles(&tile, 1, 1, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+
+		BallObject &ball = sim.Balls[0];
+		glm::vec2 brickMax = level.BrickPositions[0] + level.BrickSize;
+		ball.Position = brickMax + test.Center - ball.Radius;
+		ball.Velocity = test.Velocity;
+		ball.Stuck = false;
+		sim.Update(1.0f / 240.0f);
+
+		std::uint32_t hitMask;
+		glm::vec2 difference;
+		CircleAABBBatchScalar(ball.Position + ball.Radius, ball.Radius, level.BrickPositions.data(), level.BrickSize, 1,
+			&hitMask, &difference);
+		bool outside = glm::length(difference) >= ball.Radius - 0.01f;
+		bool hit = !sim.Events.empty() && (sim.Events[0].Type == (test.Solid ? EVENT_SOLID_HIT : EVENT_BRICK_DESTROYED));
+		bool bounced = glm::dot(ball.Velocity, test.Velocity) < 0.0f;
+		bool passed = outside && hit == test.Hits && bounced == test.Hits;
+		if (!passed)
+		{
+			std::cout << "brick overlap:     " << test.Name << " FAILED (" << (outside ? "" : "still inside, ")
+				<< (hit ? "hit" : "no hit") << ", " << (bounced ? "bounced" : "not bounced") << ")" << std::endl;
+			++failures;
+		}
+	}
+
+	std::cout << "brick overlap:     " << sizeof(cases) / sizeof(cases[0]) << " starting overlaps, " << failures << " failed" << std::endl;
+	return failures == 0;
+}
+
+int SelfCheck()
+{
+	bool passed = CheckCollisionKernels();
+	passed = CheckBrickOverlaps() && passed;
+	passed = CheckReplay() && passed;
+	passed = CheckRewind() && passed;
+	std::cout << (passed ? "self-check passed" : "SELF-CHECK FAILED") << std::endl;
+	return passed ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "--self-check") == 0)
+		return SelfCheck();
+
+	if (argc > 1 && std::strcmp(argv[1], "--collision-bench") == 0)
+	{
+		int bricks = argc > 2 ? std::atoi(argv[2]) : 10000;
+		if (bricks <= 0)
+		{
+			std::cout << "Usage: breakout_sim --collision-bench [bricks]" << std::endl;
+			return -1;
+		}
+		return CollisionBenchmark(static_cast<unsigned int>(bricks));
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--particle-bench") == 0)
+	{
+		int particles = argc > 2 ? std::atoi(argv[2]) : 1000000;
+		int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		if (particles <= 0 || threads <= 0)
+		{
+			std::cout << "Usage: breakout_sim --particle-bench [particles] [threads]" << std::endl;
+			return -1;
+		}
+		return ParticleBenchmark(static_cast<unsigned int>(particles), static_cast<unsigned int>(threads));
+	}
+
+	if (argc > 2 && std::strcmp(argv[1], "--replay") == 0)
+	{
+		std::uint64_t seekTick = 0;
+		if (argc > 4 && std::strcmp(argv[3], "--seek") == 0)
+			seekTick = std::strtoull(argv[4], nullptr, 10);
+		return PlayReplay(argv[2], seekTick);
+	}
+
+	// Split options from positional arguments
+	std::vector<const char *> positional;
+	int extraBalls = 0;
+	float ballRadius = 4.0f;
+	std::uint64_t seed = Random::DEFAULT_SEED;
+	const char *recordFile = nullptr;
+	const char *levelFile = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--balls") == 0 && i + 1 < argc)
+			extraBalls = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--ball-radius") == 0 && i + 1 < argc)
+			ballRadius = static_cast<float>(std::atof(argv[++i]));
+		else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			seed = std::strtoull(argv[++i], nullptr, 0);
+		else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+			recordFile = argv[++i];
+		else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+			levelFile = argv[++i];
+		else
+			positional.push_back(argv[i]);
+	}
+
+	unsigned long long ticks = positional.size() > 0 ? std::strtoull(positional[0], nullptr, 10) : 100000;
+	float tickRate = positional.size() > 1 ? static_cast<float>(std::atof(positional[1])) : 240.0f;
+	if (ticks == 0 || tickRate <= 0.0f || extraBalls < 0 || ballRadius <= 0.0f || (levelFile && recordFile))
+	{
+		std::cout << "Usage: breakout_sim [ticks] [tick rate in Hz] [--balls count] [--ball-radius radius] [--seed seed] [--level file | --record file]" << std::endl;
+		std::cout << "       breakout_sim --replay file [--seek tick]" << std::endl;
+		return -1;
+	}
+	float dt = 1.0f / tickRate;
+
+	Simulation sim(SCREEN_WIDTH, SCREEN_HEIGHT, seed);
+	sim.Init();
+	if (levelFile)
+	{
+		GameLevel &level = sim.Levels[sim.currentLevel];
+		auto loadStart = std::chrono::steady_clock::now();
+		if (!level.Load(levelFile, SCREEN_WIDTH, SCREEN_HEIGHT / 2))
+			return -1;
+		auto loadEnd = std::chrono::steady_clock::now();
+		std::cout << "level:            " << levelFile << ", " << level.Columns << "x" << level.Rows << ", "
+			<< level.BrickCount() << " bricks, loaded in "
+			<< std::chrono::duration<double, std::milli>(loadEnd - loadStart).count() << " ms" << std::endl;
+	}
+	if (extraBalls > 0)
+		sim.SpawnBalls(static_cast<unsigned int>(extraBalls), ballRadius);
+
+	Replay replay;
+	ReplayRecorder recorder(replay, seed, dt, REPLAY_KEYFRAME_INTERVAL);
+
+	unsigned long long bricksDestroyed = 0, ballsLost = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < ticks; ++i)
+	{
+		SimInput input = Autopilot(sim);
+		if (recordFile)
+			recorder.BeginTick(sim, input);
+
+		sim.ProcessInput(input, dt);
+		sim.Update(dt);
+
+		if (recordFile)
+			recorder.EndTick(sim);
+
+		for (const SimEvent &event : sim.Events)
+		{
+			if (event.Type == EVENT_BRICK_DESTROYED)
+				++bricksDestroyed;
+			else if (event.Type == EVENT_BALL_LOST)
+				++ballsLost;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double elapsedMs = std::chrono::duration<double, std::milli>(end - start).count();
+	std::cout << "ticks:            " << ticks << " (" << tickRate << " Hz, "
+		<< ticks / tickRate << " s simulated)" << std::endl;
+	std::cout << "elapsed:          " << elapsedMs << " ms" << std::endl;
+	std::cout << "ticks per ms:     " << (elapsedMs > 0.0 ? ticks / elapsedMs : 0.0) << std::endl;
+	std::cout << "bricks destroyed: " << bricksDestroyed << std::endl;
+	std::cout << "balls lost:       " << ballsLost << std::endl;
+	std::cout << "balls in play:    " << sim.Balls.size() << std::endl;
+
+	if (recordFile && !replay.Save(recordFile))
+		return -1;
+	return 0;
+}
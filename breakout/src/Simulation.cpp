@@ -0,0 +1,844 @@
+#include "Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "EmbeddedLevel.h"
+#include "EmbeddedLevels.h"
+
+// Power-up effects
+static void ActivateSpeed(Simulation &sim)
+{
+	for (BallObject &ball : sim.Balls)
+		ball.Velocity *= 1.2;
+}
+
+static void ActivateSticky(Simulation &sim)
+{
+	for (BallObject &ball : sim.Balls)
+		ball.Sticky = true;
+	sim.Player.Color = glm::vec3(1.0f, 0.5f, 1.0f);
+}
+
+static void DeactivateSticky(Simulation &sim)
+{
+	for (BallObject &ball : sim.Balls)
+		ball.Sticky = false;
+	sim.Player.Color = glm::vec3(1.0f);
+}
+
+static void ActivatePassThrough(Simulation &sim)
+{
+	for (BallObject &ball : sim.Balls)
+	{
+		ball.PassThrough = true;
+		ball.Color = glm::vec3(1.0f, 0.5f, 0.5f);
+	}
+}
+
+static void DeactivatePassThrough(Simulation &sim)
+{
+	for (BallObject &ball : sim.Balls)
+	{
+		ball.PassThrough = false;
+		ball.Color = glm::vec3(1.0f);
+	}
+}
+
+static void ActivatePadSizeIncrease(Simulation &sim)
+{
+	sim.Player.Size.x += 50;
+}
+
+static void ActivateConfuse(Simulation &sim)
+{
+	if (!sim.Chaos)
+		sim.Confuse = true; // only activate if chaos wasn't already active
+}
+
+static void DeactivateConfuse(Simulation &sim)
+{
+	sim.Confuse = false;
+}
+
+static void ActivateChaos(Simulation &sim)
+{
+	if (!sim.Confuse)
+		sim.Chaos = true;
+}
+
+static void DeactivateChaos(Simulation &sim)
+{
+	sim.Chaos = false;
+}
+
+static void ActivateMultiBall(Simulation &sim)
+{
+	sim.SplitBalls();
+}
+
+// Indexed by PowerUpType
+static constexpr PowerUpDefinition POWERUP_DEFINITIONS[POWERUP_TYPE_COUNT] = {
+	// name                 weight duration color                            texture       activate                  deactivate
+	{ "speed",              1,     0.0f,    glm::vec3(0.5f, 0.5f, 1.0f),  "speed",       ActivateSpeed,            nullptr },
+	{ "sticky",             1,     0.0f,    glm::vec3(0.5f, 0.5f, 1.0f),  "sticky",      ActivateSticky,           DeactivateSticky },
+	{ "pass-through",       1,     0.0f,    glm::vec3(0.5f, 0.5f, 1.0f),  "passthrough", ActivatePassThrough,      DeactivatePassThrough },
+	{ "pad-size-increase",  1,     0.0f,    glm::vec3(0.5f, 0.5f, 1.0f),  "increase",    ActivatePadSizeIncrease,  nullptr },
+	{ "confuse",            5,     0.0f,    glm::vec3(0.5f, 0.5f, 1.0f),  "confuse",     ActivateConfuse,          DeactivateConfuse },
+	{ "chaos",              5,     0.0f,    glm::vec3(0.5f, 0.5f, 1.0f),  "chaos",       ActivateChaos,            DeactivateChaos },
+	{ "multi-ball",         1,     0.0f,    glm::vec3(0.5f, 0.5f, 1.0f),  "face",        ActivateMultiBall,        nullptr }
+};
+
+// Running sum of the spawn weights, so one roll selects the type
+struct PowerUpSpawnTable
+{
+	unsigned int Weights[POWERUP_TYPE_COUNT];
+
+	constexpr PowerUpSpawnTable()
+		: Weights()
+	{
+		unsigned int sum = 0;
+		for (unsigned int type = 0; type < POWERUP_TYPE_COUNT; ++type)
+		{
+			sum += POWERUP_DEFINITIONS[type].SpawnWeight;
+			Weights[type] = sum;
+		}
+	}
+};
+
+static constexpr PowerUpSpawnTable POWERUP_SPAWN_CUMULATIVE;
+static_assert(POWERUP_SPAWN_CUMULATIVE.Weights[POWERUP_TYPE_COUNT - 1] <= POWERUP_SPAWN_ROLL,
+	"power-up spawn weights exceed the roll range");
+
+const PowerUpDefinition &Simulation::PowerUpInfo(PowerUpType type)
+{
+	return POWERUP_DEFINITIONS[type];
+}
+
+Simulation::Simulation(unsigned int width, unsigned int height, std::uint64_t seed)
+	: State(GAME_ACTIVE), Width(width), Height(height), currentLevel(0),
+	ActivePowerUps(), Confuse(false), Chaos(false), Shake(false), Rng(seed),
+	PLAYER_SIZE(100.0f, 20.0f), PLAYER_VELOCITY(500.0f),
+	BALL_RADIUS(12.5f), INITIAL_BALL_VELOCITY(100.0f, -350.0f)
+{
+}
+
+void Simulation::Init()
+{
+	// Load levels (compiled into the binary, see EmbeddedLevels.h)
+	GameLevel one;
+	LoadEmbeddedLevel<ONE_LVL>(one, this->Width, this->Height / 2);
+	GameLevel two;
+	LoadEmbeddedLevel<TWO_LVL>(two, this->Width, this->Height / 2);
+	GameLevel three;
+	LoadEmbeddedLevel<THREE_LVL>(three, this->Width, this->Height / 2);
+	GameLevel four;
+	LoadEmbeddedLevel<FOUR_LVL>(four, this->Width, this->Height / 2);
+
+	this->Levels.push_back(one);
+	this->Levels.push_back(two);
+	this->Levels.push_back(three);
+	this->Levels.push_back(four);
+	this->currentLevel = 0;
+
+	// Configure GameObjects
+	glm::vec2 playerPos = glm::vec2(
+		this->Width / 2.0f - PLAYER_SIZE.x / 2.0f,
+		this->Height - PLAYER_SIZE.y
+	);
+	Player = GameObject(playerPos, PLAYER_SIZE);
+
+	glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS,
+											  -BALL_RADIUS * 2.0f);
+	Balls.clear();
+	Balls.push_back(BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY));
+}
+
+void Simulation::ProcessInput(const SimInput &input, float dt)
+{
+	if (this->State == GAME_ACTIVE)
+	{
+		float velocity = PLAYER_VELOCITY * dt;
+
+		// Move player paddle (and the balls stuck to it)
+		float move = 0.0f;
+		if (input.Left && Player.Position.x >= 0.0f)
+			move -= velocity;
+		if (input.Right && Player.Position.x <= this->Width - Player.Size.x)
+			move += velocity;
+		Player.Position.x += move;
+
+		for (BallObject &ball : Balls)
+		{
+			if (ball.Stuck)
+			{
+				ball.Position.x += move;
+
+				// Start game
+				if (input.Launch)
+					ball.Stuck = false;
+			}
+		}
+	}
+}
+
+void Simulation::Update(float dt)
+{
+	this->Events.clear();
+
+	// Move the balls one after the other, resolving wall, brick and paddle
+	// contacts on the way, then separate balls that ran into each other
+	for (BallObject &ball : Balls)
+		this->MoveBall(ball, dt);
+	this->DoBallCollisions();
+
+	// Paddle and power-up overlap pass
+	this->DoCollisions();
+
+	// Remove balls that passed the bottom edge; losing the last one resets the level
+	Balls.erase(std::remove_if(Balls.begin(), Balls.end(),
+		[this](const BallObject &ball) { return ball.Position.y >= this->Height; }
+	), Balls.end());
+
+	if (Balls.empty())
+	{
+		this->pushEvent(EVENT_BALL_LOST, Player.Position);
+		this->ResetLevel();
+		this->ResetPlayer();
+	}
+
+	this->UpdatePowerUps(dt);
+
+	if (ShakeTime > 0.0f)
+	{
+		ShakeTime -= dt;
+		if (ShakeTime <= 0.0f)
+			Shake = false;
+	}
+}
+
+void Simulation::MoveBall(BallObject &ball, float dt)
+{
+	// If stuck to the player paddle it only follows it (see ProcessInput)
+	if (ball.Stuck)
+		return;
+
+	enum ContactType { CONTACT_NONE, CONTACT_WALL, CONTACT_BRICK, CONTACT_PADDLE };
+
+	GameLevel &level = this->Levels[this->currentLevel];
+
+	// Fraction of this tick's displacement the ball still has to travel
+	float remaining = 1.0f;
+
+	for (unsigned int contact = 0; contact < MAX_BALL_CONTACTS; ++contact)
+	{
+		glm::vec2 center = ball.Position + ball.Radius;
+		glm::vec2 displacement = ball.Velocity * dt * remaining;
+
+		// Bricks, only those overlapping a circle that bounds the whole sweep
+		brickCandidates.clear();
+		level.QueryBricks(center + displacement * 0.5f,
+			ball.Radius + glm::length(displacement) * 0.5f, brickCandidates);
+
+		// Sweeps only find bricks the ball moves into, so a ball that starts
+		// out overlapping one (e.g. pushed there by another ball) is first
+		// pushed out, and its path looked at again from there
+		if (contact == 0 && this->resolveBrickOverlaps(ball, brickCandidates))
+		{
+			center = ball.Position + ball.Radius;
+			displacement = ball.Velocity * dt * remaining;
+			brickCandidates.clear();
+			level.QueryBricks(center + displacement * 0.5f,
+				ball.Radius + glm::length(displacement) * 0.5f, brickCandidates);
+		}
+
+		// Find the earliest contact along the remaining path
+		ContactType type = CONTACT_NONE;
+		SweepHit earliest;
+		earliest.Time = 2.0f;
+		unsigned int hitBrickId = 0;
+
+		// Window walls (left, right and top; the bottom is open)
+		if (displacement.x < 0.0f)
+		{
+			float t = std::max((ball.Radius - center.x) / displacement.x, 0.0f);
+			if (t <= 1.0f && t < earliest.Time)
+			{
+				earliest = { t, glm::vec2(1.0f, 0.0f) };
+				type = CONTACT_WALL;
+			}
+		}
+		else if (displacement.x > 0.0f)
+		{
+			float t = std::max((this->Width - ball.Radius - center.x) / displacement.x, 0.0f);
+			if (t <= 1.0f && t < earliest.Time)
+			{
+				earliest = { t, glm::vec2(-1.0f, 0.0f) };
+				type = CONTACT_WALL;
+			}
+		}
+		if (displacement.y < 0.0f)
+		{
+			float t = std::max((ball.Radius - center.y) / displacement.y, 0.0f);
+			if (t <= 1.0f && t < earliest.Time)
+			{
+				earliest = { t, glm::vec2(0.0f, 1.0f) };
+				type = CONTACT_WALL;
+			}
+		}
+
+		for (unsigned int brick : brickCandidates)
+		{
+			glm::vec2 brickPosition = level.BrickPositions[brick];
+			SweepHit hit;
+			if (SweepCircleAABB(center, ball.Radius, displacement,
+				brickPosition, brickPosition + level.BrickSize, hit) && hit.Time < earliest.Time)
+			{
+				earliest = hit;
+				type = CONTACT_BRICK;
+				hitBrickId = brick;
+			}
+		}
+
+		// Player paddle, only when coming down onto it
+		if (displacement.y > 0.0f)
+		{
+			SweepHit hit;
+			if (SweepCircleAABB(center, ball.Radius, displacement,
+				Player.Position, Player.Position + Player.Size, hit) && hit.Time < earliest.Time)
+			{
+				earliest = hit;
+				type = CONTACT_PADDLE;
+			}
+		}
+
+		if (type == CONTACT_NONE)
+		{
+			ball.Position += displacement;
+			return;
+		}
+
+		// Advance to the contact and resolve it
+		ball.Position += displacement * earliest.Time;
+		remaining *= 1.0f - earliest.Time;
+
+		if (type == CONTACT_WALL)
+			ball.Velocity = glm::reflect(ball.Velocity, earliest.Normal);
+		else if (type == CONTACT_BRICK)
+			this->hitBrick(ball, hitBrickId, earliest.Normal);
+		else
+		{
+			this->hitPaddle(ball);
+			if (ball.Stuck)
+				return;
+		}
+	}
+}
+
+void Simulation::DoCollisions()
+{
+	// Ball - Player overlap. Contacts while the ball moves are handled in
+	// MoveBall; this catches the paddle itself moving into a ball
+	for (BallObject &ball : Balls)
+		if (!ball.Stuck && ball.Velocity.y > 0.0f && CheckCollision(ball, Player))
+			this->hitPaddle(ball);
+
+	for (unsigned int i = 0; i < PowerUps.Capacity(); ++i)
+	{
+		PowerUp &powerUp = PowerUps[i];
+		if (PowerUps.IsAlive(i) && !powerUp.Destroyed)
+		{
+			if (powerUp.Position.y >= this->Height)
+				powerUp.Destroyed = true;
+			if (CheckCollision(Player, powerUp))
+			{
+				ActivatePowerUp(powerUp);
+				powerUp.Destroyed = true;
+				powerUp.Activated = true;
+				this->pushEvent(EVENT_POWERUP_COLLECTED, powerUp.Position);
+			}
+		}
+	}
+}
+
+bool Simulation::resolveBrickOverlaps(BallObject &ball, const std::vector<unsigned int> &bricks)
+{
+	GameLevel &level = this->Levels[this->currentLevel];
+	bool resolved = false;
+	for (unsigned int brick : bricks)
+	{
+		// Leaving one brick may already have cleared the next
+		glm::vec2 center = ball.Position + ball.Radius;
+		std::uint32_t hitMask;
+		glm::vec2 difference;
+		if (CircleAABBBatchScalar(center, ball.Radius, &level.BrickPositions[brick], level.BrickSize, 1,
+			&hitMask, &difference) == 0)
+			continue;
+
+		// difference runs from the center to the closest point of the brick,
+		// so the ball leaves the other way. A center inside the brick leaves
+		// through the nearest face
+		glm::vec2 normal;
+		float depth;
+		float distance = glm::length(difference);
+		if (distance > 0.0f)
+		{
+			normal = -difference / distance;
+			depth = ball.Radius - distance;
+		}
+		else
+		{
+			glm::vec2 brickMin = level.BrickPositions[brick];
+			glm::vec2 brickMax = brickMin + level.BrickSize;
+			const float faceDistances[4] = { center.x - brickMin.x, brickMax.x - center.x, center.y - brickMin.y, brickMax.y - center.y };
+			const glm::vec2 faceNormals[4] = { glm::vec2(-1.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, -1.0f), glm::vec2(0.0f, 1.0f) };
+			unsigned int face = static_cast<unsigned int>(std::min_element(faceDistances, faceDistances + 4) - faceDistances);
+			normal = faceNormals[face];
+			depth = faceDistances[face] + ball.Radius;
+		}
+		if (depth <= 0.0f)
+			continue; // just touching
+
+		// Pass-through balls stay where they are in breakable bricks. A solid
+		// brick the ball is already leaving is only pushed out of, so resting
+		// contact doesn't shake the screen every tick
+		bool solid = level.IsSolid(brick);
+		if (!(ball.PassThrough && !solid))
+			ball.Position += normal * depth;
+		if (!solid || glm::dot(ball.Velocity, normal) < 0.0f)
+			this->hitBrick(ball, brick, normal);
+		resolved = true;
+	}
+	return resolved;
+}
+
+void Simulation::hitBrick(BallObject &ball, unsigned int brick, glm::vec2 normal)
+{
+	GameLevel &level = this->Levels[this->currentLevel];
+	glm::vec2 position = level.BrickPositions[brick];
+	bool solid = level.IsSolid(brick);
+
+	// Destroy block if not solid
+	if (!solid)
+	{
+		level.DestroyBrick(brick);
+		this->SpawnPowerUps(position);
+		this->pushEvent(EVENT_BRICK_DESTROYED, position, brick);
+	}
+	else
+	{
+		// If block is solid, enable shake effect
+		ShakeTime = 0.05f;
+		Shake = true;
+		this->pushEvent(EVENT_SOLID_HIT, position, brick);
+	}
+
+	// Pass-through balls keep going through breakable blocks; balls already
+	// moving away from the brick keep going as well
+	if (!(ball.PassThrough && !solid) && glm::dot(ball.Velocity, normal) < 0.0f)
+		ball.Velocity = glm::reflect(ball.Velocity, normal);
+}
+
+void Simulation::hitPaddle(BallObject &ball)
+{
+	// Check where it hit in the board and change velocity abse on where it hit
+	float centerBoard = Player.Position.x + Player.Size.x / 2.0f;
+	float distance = (ball.Position.x + ball.Radius) - centerBoard;
+	float percentage = distance / (Player.Size.x / 2.0f);
+
+	// Move acordingly
+	float strength = 2.0f;
+	glm::vec2 oldVelocity = ball.Velocity;
+	ball.Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
+	ball.Velocity.y = -1.0f * std::abs(ball.Velocity.y);
+	ball.Velocity = glm::normalize(ball.Velocity) * glm::length(oldVelocity);
+
+	ball.Stuck = ball.Sticky;
+
+	this->pushEvent(EVENT_PADDLE_HIT, ball.Position);
+}
+
+void Simulation::ActivatePowerUp(PowerUp &powerUp)
+{
+	const PowerUpDefinition &definition = PowerUpInfo(powerUp.Type);
+	definition.Activate(*this);
+	++ActivePowerUps[powerUp.Type];
+}
+
+void Simulation::UpdatePowerUps(float dt)
+{
+	for (unsigned int i = 0; i < PowerUps.Capacity(); ++i)
+	{
+		if (!PowerUps.IsAlive(i))
+			continue;
+
+		PowerUp &powerUp = PowerUps[i];
+		powerUp.Position += powerUp.Velocity * dt;
+		if (powerUp.Activated)
+		{
+			powerUp.Duration -= dt;
+
+			if (powerUp.Duration <= 0.0f)
+			{
+				// remove powerup from list (will later be removed)
+				powerUp.Activated = false;
+				// deactivate effects, only if no other PowerUp of this type is active
+				if (--ActivePowerUps[powerUp.Type] == 0)
+				{
+					const PowerUpDefinition &definition = PowerUpInfo(powerUp.Type);
+					if (definition.Deactivate)
+						definition.Deactivate(*this);
+				}
+			}
+		}
+
+		// Free the slot once the power-up is neither falling nor active
+		if (powerUp.Destroyed && !powerUp.Activated)
+			PowerUps.Release(i);
+	}
+}
+
+bool Simulation::IsPowerUpActive(PowerUpType type) const
+{
+	return ActivePowerUps[type] > 0;
+}
+
+void Simulation::ResetLevel()
+{
+	// Levels are parsed once in Init; resetting just clears the destroyed flags
+	this->Levels[this->currentLevel].Reset();
+}
+
+void Simulation::ResetPlayer()
+{
+	Player.Size = PLAYER_SIZE;
+	Player.Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
+	Balls.resize(1);
+	Balls[0].Radius = BALL_RADIUS;
+	Balls[0].Size = glm::vec2(BALL_RADIUS * 2.0f);
+	Balls[0].Color = glm::vec3(1.0f);
+	Balls[0].Reset(Player.Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -(BALL_RADIUS * 2.0f)), INITIAL_BALL_VELOCITY);
+}
+
+void Simulation::Save(std::vector<std::uint8_t> &out) const
+{
+	out.clear();
+	ByteWriter writer(out);
+
+	writer.Put(this->State);
+	writer.Put(this->currentLevel);
+	this->Player.Save(writer);
+
+	writer.PutVarint(this->Balls.size());
+	for (const BallObject &ball : this->Balls)
+		ball.Save(writer);
+
+	this->PowerUps.Save(writer);
+	writer.Put(this->ActivePowerUps);
+
+	writer.Put(this->Confuse);
+	writer.Put(this->Chaos);
+	writer.Put(this->Shake);
+	writer.Put(this->ShakeTime);
+	writer.Put(this->Rng.State);
+
+	for (const GameLevel &level : this->Levels)
+		writer.PutBytes(level.DestroyedWords().data(), level.DestroyedWords().size() * sizeof(std::uint64_t));
+}
+
+bool Simulation::Restore(const std::uint8_t *data, std::size_t size)
+{
+	ByteReader reader(data, size);
+
+	unsigned int level;
+	if (!reader.Get(this->State) || !reader.Get(level) || level >= this->Levels.size())
+		return false;
+	this->currentLevel = level;
+	if (!this->Player.Restore(reader))
+		return false;
+
+	std::uint64_t ballCount;
+	if (!reader.GetVarint(ballCount) || ballCount > size)
+		return false;
+	this->Balls.resize(static_cast<std::size_t>(ballCount));
+	for (BallObject &ball : this->Balls)
+		if (!ball.Restore(reader))
+			return false;
+
+	if (!this->PowerUps.Restore(reader) || !reader.Get(this->ActivePowerUps))
+		return false;
+
+	if (!reader.Get(this->Confuse) || !reader.Get(this->Chaos) || !reader.Get(this->Shake)
+		|| !reader.Get(this->ShakeTime) || !reader.Get(this->Rng.State))
+		return false;
+
+	for (GameLevel &level : this->Levels)
+	{
+		const std::uint8_t *words = reader.Skip(level.DestroyedWords().size() * sizeof(std::uint64_t));
+		if (!words)
+			return false;
+		level.RestoreDestroyedWords(words);
+	}
+
+	return reader.AtEnd();
+}
+
+std::uint64_t Simulation::StateHash()
+{
+	this->Save(this->hashScratch);
+
+	std::uint64_t hash = 0xCBF29CE484222325ull;
+	for (std::uint8_t byte : this->hashScratch)
+		hash = (hash ^ byte) * 0x100000001B3ull;
+	return hash;
+}
+
+// Rotates a vector counter-clockwise by the given angle in radians
+static glm::vec2 rotate(glm::vec2 v, float angle)
+{
+	float c = std::cos(angle), s = std::sin(angle);
+	return glm::vec2(c * v.x - s * v.y, s * v.x + c * v.y);
+}
+
+void Simulation::SplitBalls()
+{
+	// Every ball in play forks into three, fanning out by 30 degrees
+	size_t count = Balls.size();
+	for (size_t i = 0; i < count && Balls.size() + 2 <= MULTI_BALL_LIMIT; ++i)
+	{
+		if (Balls[i].Stuck)
+			continue;
+
+		for (float angle : { -0.5236f, 0.5236f })
+		{
+			BallObject ball = Balls[i];
+			ball.Velocity = rotate(ball.Velocity, angle);
+			Balls.push_back(ball);
+		}
+	}
+}
+
+void Simulation::SpawnBalls(unsigned int count, float radius)
+{
+	// Lay the balls out on a grid in the empty space between the bricks and
+	// the paddle (wrapping around, i.e. overlapping, if they don't fit) and
+	// launch them in evenly spread directions
+	float spacing = radius * 2.0f + 1.0f;
+	unsigned int columns = std::max(static_cast<unsigned int>(this->Width / spacing), 1u);
+	unsigned int rows = std::max(static_cast<unsigned int>((this->Height / 2 - PLAYER_SIZE.y) / spacing), 1u);
+	float speed = glm::length(INITIAL_BALL_VELOCITY);
+
+	Balls.reserve(Balls.size() + count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int cell = i % (columns * rows);
+		glm::vec2 position((cell % columns) * spacing, this->Height / 2 + (cell / columns) * spacing);
+		float angle = 6.2831853f * (i + 0.5f) / count;
+
+		BallObject ball(position, radius, speed * glm::vec2(std::cos(angle), std::sin(angle)));
+		ball.Stuck = false;
+		Balls.push_back(ball);
+	}
+}
+
+// Hashes a grid cell into a table with tableMask + 1 buckets
+static inline unsigned int hashCell(int x, int y, unsigned int tableMask)
+{
+	return (static_cast<unsigned int>(x) * 73856093u ^ static_cast<unsigned int>(y) * 19349663u) & tableMask;
+}
+
+void Simulation::DoBallCollisions()
+{
+	size_t count = Balls.size();
+	if (count < 2)
+		return;
+
+	// Spatial hash with cells as wide as the biggest ball up to twice the
+	// radius of the smallest one. Balls that fit in a cell are always in the
+	// same or a neighbouring cell as every ball they touch; the few bigger
+	// ones (e.g. the served ball among thousands of tiny stress balls) are
+	// tested against all others instead
+	float minRadius = Balls[0].Radius;
+	for (const BallObject &ball : Balls)
+		minRadius = std::min(minRadius, ball.Radius);
+	float cellSize = 0.0f;
+	for (const BallObject &ball : Balls)
+		if (ball.Radius <= minRadius * 2.0f)
+			cellSize = std::max(cellSize, ball.Radius * 2.0f);
+	float inverseCellSize = 1.0f / cellSize;
+
+	unsigned int tableSize = 1;
+	while (tableSize < count * 2)
+		tableSize <<= 1;
+	unsigned int tableMask = tableSize - 1;
+
+	// Counting sort of ball indices by bucket: bucket b holds
+	// ballBucketEntries[ballBucketStart[b] .. ballBucketStart[b + 1])
+	ballBucketStart.assign(tableSize + 1, 0);
+	ballBuckets.resize(count);
+	ballBucketEntries.resize(count);
+	largeBalls.clear();
+	for (size_t i = 0; i < count; ++i)
+	{
+		glm::vec2 center = Balls[i].Position + Balls[i].Radius;
+		ballBuckets[i] = hashCell(static_cast<int>(std::floor(center.x * inverseCellSize)),
+			static_cast<int>(std::floor(center.y * inverseCellSize)), tableMask);
+		++ballBucketStart[ballBuckets[i] + 1];
+
+		if (Balls[i].Radius * 2.0f > cellSize)
+			largeBalls.push_back(static_cast<unsigned int>(i));
+	}
+	for (unsigned int b = 0; b < tableSize; ++b)
+		ballBucketStart[b + 1] += ballBucketStart[b];
+	ballBucketFill.assign(ballBucketStart.begin(), ballBucketStart.end() - 1);
+	for (size_t i = 0; i < count; ++i)
+		ballBucketEntries[ballBucketFill[ballBuckets[i]]++] = static_cast<unsigned int>(i);
+
+	// Gather the circles in bucket order, so the pair tests below walk
+	// contiguous memory instead of jumping around Balls. Balls that take no
+	// part in the hashed tests get a negative radius. Separating a pair
+	// updates both circles, so later tests see the balls where they are now;
+	// the buckets aren't rebuilt, as a separation moves a ball by less than
+	// its radius
+	ballBucketCircles.resize(count);
+	for (size_t e = 0; e < count; ++e)
+	{
+		const BallObject &ball = Balls[ballBucketEntries[e]];
+		bool skip = ball.Stuck || ball.Radius * 2.0f > cellSize;
+		ballBucketCircles[e] = glm::vec3(ball.Position + ball.Radius, skip ? -1.0f : ball.Radius);
+	}
+
+	// Walk the balls in bucket order too, so consecutive balls look at the
+	// same neighbourhood and its buckets stay in cache
+	for (size_t entry = 0; entry < count; ++entry)
+	{
+		if (ballBucketCircles[entry].z < 0.0f)
+			continue;
+
+		BallObject &one = Balls[ballBucketEntries[entry]];
+		glm::vec2 center(ballBucketCircles[entry]);
+		int cellX = static_cast<int>(std::floor(center.x * inverseCellSize));
+		int cellY = static_cast<int>(std::floor(center.y * inverseCellSize));
+
+		// Visit each distinct bucket of the 3x3 neighbourhood once
+		unsigned int visited[9];
+		unsigned int visitedCount = 0;
+		for (int dy = -1; dy <= 1; ++dy)
+		{
+			for (int dx = -1; dx <= 1; ++dx)
+			{
+				unsigned int bucket = hashCell(cellX + dx, cellY + dy, tableMask);
+				if (std::find(visited, visited + visitedCount, bucket) != visited + visitedCount)
+					continue;
+				visited[visitedCount++] = bucket;
+
+				// Each pair is handled once, from the ball that comes first in
+				// bucket order (whole buckets are either before or after this
+				// one, except its own); pairs with a large ball are handled below
+				unsigned int first = std::max(ballBucketStart[bucket], static_cast<unsigned int>(entry) + 1);
+				for (unsigned int e = first; e < ballBucketStart[bucket + 1]; ++e)
+				{
+					const glm::vec3 &circle = ballBucketCircles[e];
+					if (circle.z < 0.0f)
+						continue;
+
+					glm::vec2 delta = glm::vec2(circle) - center;
+					float reach = circle.z + one.Radius;
+					if (glm::dot(delta, delta) < reach * reach)
+					{
+						BallObject &two = Balls[ballBucketEntries[e]];
+						this->resolveBallCollision(one, two);
+						center = one.Position + one.Radius;
+						ballBucketCircles[entry] = glm::vec3(center, one.Radius);
+						ballBucketCircles[e] = glm::vec3(two.Position + two.Radius, two.Radius);
+					}
+				}
+			}
+		}
+	}
+
+	for (size_t l = 0; l < largeBalls.size(); ++l)
+	{
+		unsigned int i = largeBalls[l];
+		if (Balls[i].Stuck)
+			continue;
+
+		for (size_t j = 0; j < count; ++j)
+		{
+			// Large - large pairs are handled by the lower index only
+			bool large = Balls[j].Radius * 2.0f > cellSize;
+			if (j == i || Balls[j].Stuck || (large && j < i))
+				continue;
+			this->resolveBallCollision(Balls[i], Balls[j]);
+		}
+	}
+}
+
+void Simulation::resolveBallCollision(BallObject &one, BallObject &two)
+{
+	glm::vec2 delta = (two.Position + two.Radius) - (one.Position + one.Radius);
+	float minDistance = one.Radius + two.Radius;
+	float distanceSquared = glm::dot(delta, delta);
+	if (distanceSquared >= minDistance * minDistance || distanceSquared == 0.0f)
+		return;
+
+	float distance = std::sqrt(distanceSquared);
+	glm::vec2 normal = delta / distance;
+
+	// Push the balls apart so they just touch
+	glm::vec2 separation = normal * ((minDistance - distance) * 0.5f);
+	one.Position -= separation;
+	two.Position += separation;
+
+	// Elastic collision between equal masses: swap the velocity components
+	// along the normal, if the balls are moving towards each other
+	float approach = glm::dot(two.Velocity - one.Velocity, normal);
+	if (approach < 0.0f)
+	{
+		one.Velocity += normal * approach;
+		two.Velocity -= normal * approach;
+	}
+}
+
+void Simulation::SpawnPowerUps(glm::vec2 position)
+{
+	// One roll picks at most one power-up, each type owning a slice of the
+	// range the size of its spawn weight
+	unsigned int roll = Rng.Below(POWERUP_SPAWN_ROLL);
+	for (unsigned int type = 0; type < POWERUP_TYPE_COUNT; ++type)
+	{
+		if (roll < POWERUP_SPAWN_CUMULATIVE.Weights[type])
+		{
+			const PowerUpDefinition &definition = PowerUpInfo(static_cast<PowerUpType>(type));
+			this->PowerUps.Spawn(
+				PowerUp(static_cast<PowerUpType>(type), definition.Color, definition.Duration, position)
+			);
+			return;
+		}
+	}
+}
+
+bool Simulation::CheckCollision(GameObject &one, GameObject &two)
+{
+	// Collision x-axis?
+	bool collisionX = one.Position.x + one.Size.x >= two.Position.x &&
+		two.Position.x + two.Size.x >= one.Position.x;
+
+	// Collision y-axis?
+	bool collisionY = one.Position.y + one.Size.y >= two.Position.y &&
+		two.Position.y + two.Size.y >= one.Position.y;
+
+	// Collision only if in both axes
+	return collisionX && collisionY;
+}
+
+bool Simulation::CheckCollision(BallObject &one, GameObject &two)
+{
+	std::uint32_t hitMask;
+	return CircleAABBBatchScalar(one.Position + one.Radius, one.Radius, &two.Position, two.Size, 1, &hitMask) > 0;
+}
+
+void Simulation::pushEvent(SimEventType type, glm::vec2 position, unsigned int brick)
+{
+	this->Events.push_back({ type, position, brick });
+}
@@ -0,0 +1,175 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "GameLevel.h"
+#include "GameObject.h"
+#include "BallObject.h"
+#include "PowerUp.h"
+#include "PowerUpPool.h"
+#include "Collision.h"
+#include "Random.h"
+
+enum GameState
+{
+	GAME_ACTIVE,
+	GAME_MENU,
+	GAME_WIN
+};
+
+// Player intent for a single tick, decoupled from any windowing library
+struct SimInput
+{
+	bool Left = false;
+	bool Right = false;
+	bool Launch = false;
+};
+
+// Things that happened during a tick that a front-end may want to react to
+// (sounds, particles, ...). Cleared at the start of every Update.
+enum SimEventType
+{
+	EVENT_BRICK_DESTROYED,
+	EVENT_SOLID_HIT,
+	EVENT_PADDLE_HIT,
+	EVENT_POWERUP_COLLECTED,
+	EVENT_BALL_LOST
+};
+
+struct SimEvent
+{
+	SimEventType Type;
+	glm::vec2 Position;
+	unsigned int Brick; // brick id for EVENT_BRICK_DESTROYED and EVENT_SOLID_HIT
+};
+
+// Pure CPU gameplay state and rules (paddle, ball, bricks, power-ups).
+// Has no dependency on OpenGL, GLFW or irrKlang, so it can be ticked
+// without a window or sound device (see SimApplication.cpp).
+class Simulation
+{
+public:
+	Simulation(unsigned int width, unsigned int height, std::uint64_t seed = Random::DEFAULT_SEED);
+
+	GameState State;
+	unsigned int Width;
+	unsigned int Height;
+
+	std::vector<GameLevel> Levels;
+	unsigned int currentLevel;
+
+	GameObject Player;
+
+	// Balls in play, stored contiguously. Balls[0] is the one served from the
+	// paddle; more are added by the multi-ball power-up or SpawnBalls
+	std::vector<BallObject> Balls;
+
+	// Falling and active power-ups; fixed capacity, slots are recycled
+	PowerUpPool PowerUps;
+
+	// Number of activated, not yet expired power-ups of each type
+	unsigned int ActivePowerUps[POWERUP_TYPE_COUNT];
+
+	// Post-processing effect flags driven by gameplay
+	bool Confuse, Chaos, Shake;
+	float ShakeTime = 0.0f;
+
+	// Random stream for all gameplay decisions (power-up drops)
+	Random Rng;
+
+	// Events raised during the last Update
+	std::vector<SimEvent> Events;
+
+	// Initial values for the player paddle
+	const glm::vec2 PLAYER_SIZE;
+	const float PLAYER_VELOCITY;
+
+	// Initial values for the ball
+	const float BALL_RADIUS;
+	const glm::vec2 INITIAL_BALL_VELOCITY;
+
+	// Load all levels and place the player and ball
+	void Init();
+
+	// Simulation step
+	void ProcessInput(const SimInput &input, float dt);
+	void Update(float dt);
+	void MoveBall(BallObject &ball, float dt);
+	void DoBallCollisions();
+	void DoCollisions();
+
+	void ResetLevel();
+	void ResetPlayer();
+
+	// Serializes all mutable gameplay state into out (level layouts are
+	// immutable after Init and not included), or restores it. Restore
+	// returns false if the data is malformed or from other levels
+	void Save(std::vector<std::uint8_t> &out) const;
+	bool Restore(const std::uint8_t *data, std::size_t size);
+
+	// FNV-1a hash of the Save()d state, used by replays to detect divergence
+	std::uint64_t StateHash();
+
+	// Multi-ball power-up: every ball in play splits into three
+	void SplitBalls();
+
+	// Stress mode: adds count launched balls of the given radius
+	void SpawnBalls(unsigned int count, float radius);
+
+	void SpawnPowerUps(glm::vec2 position);
+	void ActivatePowerUp(PowerUp &powerUp);
+	void UpdatePowerUps(float dt);
+	bool IsPowerUpActive(PowerUpType type) const;
+
+	// Static description of a power-up type (spawn weight, duration, color, texture, effects)
+	static const PowerUpDefinition &PowerUpInfo(PowerUpType type);
+
+	// Collisions
+	// AABB - AABB collision (axis-aligned bounding box)
+	bool CheckCollision(GameObject &one, GameObject &two);
+
+	// Circle - AABB overlap
+	bool CheckCollision(BallObject &one, GameObject &two);
+
+private:
+	// Most contacts (walls, bricks, paddle) the ball resolves in a single tick
+	static const unsigned int MAX_BALL_CONTACTS = 8;
+
+	// Most balls the multi-ball power-up will create
+	static const unsigned int MULTI_BALL_LIMIT = 64;
+
+	// Scratch list of bricks returned by the broadphase, reused every tick
+	std::vector<unsigned int> brickCandidates;
+
+	// Ball - ball spatial hash, rebuilt every tick (see DoBallCollisions)
+	std::vector<unsigned int> ballBuckets;
+	std::vector<unsigned int> ballBucketStart;
+	std::vector<unsigned int> ballBucketFill;
+	std::vector<unsigned int> ballBucketEntries;
+	std::vector<glm::vec3> ballBucketCircles;
+	std::vector<unsigned int> largeBalls;
+
+	// Scratch buffer for StateHash
+	std::vector<std::uint8_t> hashScratch;
+
+	// Bounce a ball off the paddle depending on where it hit
+	void hitPaddle(BallObject &ball);
+
+	// Apply the effects of a ball touching a brick
+	void hitBrick(BallObject &ball, unsigned int brick, glm::vec2 normal);
+
+	// Push a ball out of any of bricks it overlaps, hitting them as it
+	// leaves. Returns whether it overlapped any
+	bool resolveBrickOverlaps(BallObject &ball, const std::vector<unsigned int> &bricks);
+
+	// Separate two overlapping balls and bounce them off each other
+	void resolveBallCollision(BallObject &one, BallObject &two);
+
+	void pushEvent(SimEventType type, glm::vec2 position, unsigned int brick = 0);
+};
+
+#endif // !SIMULATION_H
@@ -0,0 +1,167 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "GLState.h"
+
+// Key layout: layer (8 bits) | texture ID (24 bits) | submission index (32 bits)
+static const int KEY_TEXTURE_SHIFT = 32;
+static const int KEY_LAYER_SHIFT = 56;
+static const std::uint64_t KEY_TEXTURE_MASK = 0xFFFFFF;
+
+// Quads the buffers start out with; they grow as needed
+static const unsigned int INITIAL_QUADS = 1024;
+
+SpriteBatch::SpriteBatch(Shader &shader)
+	: shader(shader), capacity(0)
+{
+	this->initRenderData();
+}
+
+SpriteBatch::~SpriteBatch()
+{
+	GLState::DeleteVertexArrays(1, &this->VAO);
+	glDeleteBuffers(1, &this->VBO);
+	glDeleteBuffers(1, &this->EBO);
+}
+
+void SpriteBatch::Begin()
+{
+	this->layer = 0;
+	this->keys.clear();
+	this->vertices.clear();
+}
+
+void SpriteBatch::Draw(const Texture2D &texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color, glm::vec4 uvRect)
+{
+	std::uint64_t index = this->keys.size();
+	this->keys.push_back(static_cast<std::uint64_t>(std::min(this->layer, 255u)) << KEY_LAYER_SHIFT
+		| (static_cast<std::uint64_t>(texture.ID) & KEY_TEXTURE_MASK) << KEY_TEXTURE_SHIFT
+		| index);
+
+	// Rotate around the center of the quad
+	glm::vec2 center = position + 0.5f * size;
+	glm::vec2 axisX(0.5f * size.x, 0.0f), axisY(0.0f, 0.5f * size.y);
+	if (rotate != 0.0f)
+	{
+		float angle = glm::radians(rotate);
+		float c = std::cos(angle), s = std::sin(angle);
+		axisX = glm::vec2(c, s) * (0.5f * size.x);
+		axisY = glm::vec2(-s, c) * (0.5f * size.y);
+	}
+
+	// uvRect is relative to the texture's region, which is all of it unless it's an atlas image
+	const glm::vec4 &region = texture.Region;
+	glm::vec2 uvMin(region.x + uvRect.x * region.z, region.y + uvRect.y * region.w);
+	glm::vec2 uvMax = uvMin + glm::vec2(uvRect.z * region.z, uvRect.w * region.w);
+	this->vertices.push_back({ center - axisX - axisY, glm::vec2(uvMin.x, uvMin.y), color });
+	this->vertices.push_back({ center + axisX - axisY, glm::vec2(uvMax.x, uvMin.y), color });
+	this->vertices.push_back({ center + axisX + axisY, glm::vec2(uvMax.x, uvMax.y), color });
+	this->vertices.push_back({ center - axisX + axisY, glm::vec2(uvMin.x, uvMax.y), color });
+}
+
+void SpriteBatch::End()
+{
+	this->SpriteCount = static_cast<unsigned int>(this->keys.size());
+	this->DrawCalls = 0;
+	if (this->keys.empty())
+		return;
+
+	// Keys are unique (they end in the submission index), so an unstable
+	// sort still keeps the submission order within a layer and texture.
+	// Usually the sprites already come grouped and the sort is skipped
+	const std::vector<Vertex> *drawVertices = &this->vertices;
+	if (!std::is_sorted(this->keys.begin(), this->keys.end()))
+	{
+		std::sort(this->keys.begin(), this->keys.end());
+		this->sortedVertices.resize(this->vertices.size());
+		for (std::size_t i = 0; i < this->keys.size(); ++i)
+		{
+			std::size_t sprite = static_cast<std::uint32_t>(this->keys[i]);
+			std::copy_n(&this->vertices[sprite * 4], 4, &this->sortedVertices[i * 4]);
+		}
+		drawVertices = &this->sortedVertices;
+	}
+
+	this->reserveQuads(this->SpriteCount);
+
+	// Orphan the old contents so the upload doesn't wait for last frame's draws
+	glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+	glBufferData(GL_ARRAY_BUFFER, this->capacity * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, drawVertices->size() * sizeof(Vertex), drawVertices->data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	this->shader.Use();
+	GLState::BindVertexArray(this->VAO);
+
+	// One draw per run of sprites sharing a texture
+	std::size_t start = 0;
+	while (start < this->keys.size())
+	{
+		std::uint64_t texture = (this->keys[start] >> KEY_TEXTURE_SHIFT) & KEY_TEXTURE_MASK;
+		std::size_t end = start + 1;
+		while (end < this->keys.size() && ((this->keys[end] >> KEY_TEXTURE_SHIFT) & KEY_TEXTURE_MASK) == texture)
+			++end;
+
+		GLState::BindTexture(0, GL_TEXTURE_2D, static_cast<unsigned int>(texture));
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>((end - start) * 6), GL_UNSIGNED_INT,
+			reinterpret_cast<const void *>(start * 6 * sizeof(unsigned int)));
+		++this->DrawCalls;
+		start = end;
+	}
+}
+
+void SpriteBatch::initRenderData()
+{
+	glGenVertexArrays(1, &this->VAO);
+	glGenBuffers(1, &this->VBO);
+	glGenBuffers(1, &this->EBO);
+
+	GLState::BindVertexArray(this->VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, TexCoords));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, Color));
+	// The element buffer binding is part of the VAO state
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
+	GLState::BindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	this->reserveQuads(INITIAL_QUADS);
+}
+
+void SpriteBatch::reserveQuads(unsigned int quads)
+{
+	if (quads <= this->capacity)
+		return;
+	unsigned int capacity = std::max(this->capacity, INITIAL_QUADS);
+	while (capacity < quads)
+		capacity *= 2;
+
+	// Every quad is two triangles over its four vertices; the indices never
+	// change, so they are only written when the buffer grows
+	std::vector<unsigned int> indices(capacity * 6);
+	for (unsigned int quad = 0; quad < capacity; ++quad)
+	{
+		unsigned int *index = &indices[quad * 6];
+		unsigned int first = quad * 4;
+		index[0] = first;
+		index[1] = first + 1;
+		index[2] = first + 2;
+		index[3] = first;
+		index[4] = first + 2;
+		index[5] = first + 3;
+	}
+
+	GLState::BindVertexArray(this->VAO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+	GLState::BindVertexArray(0);
+	this->capacity = capacity;
+}
@@ -0,0 +1,71 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Shader.h"
+#include "Texture.h"
+
+// Collects sprites between Begin and End and draws them with one draw call
+// per texture. Quads are transformed on the CPU into a shared dynamic vertex
+// buffer; End sorts them by layer, then texture, and issues a draw wherever
+// the texture changes.
+//
+// Sprites only keep their submission order within the same layer and
+// texture, so put anything that must be drawn over something else on a
+// higher layer (see SetLayer).
+class SpriteBatch
+{
+public:
+	SpriteBatch(Shader &shader);
+	~SpriteBatch();
+
+	// Starts a new batch on layer 0
+	void Begin();
+
+	// Layer of the sprites drawn from now on; higher layers are drawn on top
+	void SetLayer(unsigned int layer) { this->layer = layer; }
+
+	// Draws texture at position with size (in pixels), rotated by rotate
+	// degrees around its center and tinted with color. uvRect is the part of
+	// the texture to use (x, y, width, height in texture coordinates,
+	// relative to the texture's Region). Atlas images share one texture, so
+	// sprites drawn from the same atlas all go into one draw call
+	void Draw(const Texture2D &texture, glm::vec2 position,
+		glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f,
+		glm::vec3 color = glm::vec3(1.0f), glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+
+	// Sorts and draws everything since Begin
+	void End();
+
+	// Sprites and draw calls of the last End, for profiling
+	unsigned int SpriteCount = 0;
+	unsigned int DrawCalls = 0;
+
+private:
+	struct Vertex
+	{
+		glm::vec2 Position;
+		glm::vec2 TexCoords;
+		glm::vec3 Color;
+	};
+
+	Shader shader;
+	unsigned int VAO, VBO, EBO;
+	unsigned int capacity; // quads the index buffer covers
+
+	unsigned int layer = 0;
+	// Per sprite: layer, texture and submission order packed so that sorting
+	// the keys sorts the sprites, stably (see End)
+	std::vector<std::uint64_t> keys;
+	std::vector<Vertex> vertices;		// 4 per sprite, in submission order
+	std::vector<Vertex> sortedVertices;	// the same, in draw order
+
+	void initRenderData();
+	void reserveQuads(unsigned int quads);
+};
+
+#endif // !SPRITE_BATCH_H
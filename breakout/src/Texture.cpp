@@ -2,11 +2,14 @@
 
 #include <glad/glad.h>
 
+#include "GLState.h"
+
 Texture2D::Texture2D()
 	: Width(0), Height(0),
 	  Internal_Format(GL_RGB), Image_Format(GL_RGB),
 	  Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT),
-	  Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR) 
+	  Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR),
+	  Region(0.0f, 0.0f, 1.0f, 1.0f)
 {
 	glGenTextures(1, &this->ID);
 }
@@ -17,7 +20,7 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
 	this->Height = height;
 
 	// Create Texture
-	glBindTexture(GL_TEXTURE_2D, this->ID);
+	GLState::BindTexture(0, GL_TEXTURE_2D, this->ID);
 	glTexImage2D(GL_TEXTURE_2D, 0, this->Internal_Format, width, height, 0, this->Image_Format, GL_UNSIGNED_BYTE, data);
 
 	// Set Texture wrap and filter modes
@@ -25,12 +28,9 @@ void Texture2D::Generate(unsigned int width, unsigned int height, unsigned char*
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, this->Wrap_T);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->Filter_Min);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->Filter_Max);
-
-	// Unbind texture
-	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-void Texture2D::Bind() const 
+void Texture2D::Bind(unsigned int unit) const 
 {
-	glBindTexture(GL_TEXTURE_2D, this->ID);
-}
\ No newline at end of file
+	GLState::BindTexture(unit, GL_TEXTURE_2D, this->ID);
+}
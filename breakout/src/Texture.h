@@ -1,6 +1,8 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
+#include <glm/glm.hpp>
+
 // Texture2D is able to store and configure a texture in OpenGL.
 // It also hosts utility functions for easy management.
 class Texture2D {
@@ -21,14 +23,28 @@ public:
 	unsigned int Filter_Min; // Filtering mode if texture pixels < screen pixels
 	unsigned int Filter_Max; // Filtering mode if texture pixels > screen pixels
 
+	// Part of the texture object this handle stands for (x, y, width, height
+	// in texture coordinates): all of it, or one image of an atlas (see
+	// ResourceManager::LoadTextureAtlas), in which case Width and Height are
+	// the image's. Handles of one atlas share the ID, so drawing from them
+	// needs no rebinding
+	glm::vec4 Region;
+
 	// Constructor (sets default texture modes)
 	Texture2D();
 
 	// Generates texture from image data
 	void Generate(unsigned int width, unsigned int height, unsigned char* data);
 
-	// Binds the texture as the current active GL_TEXTURE_2D texture object
-	void Bind() const;
+	// Binds the texture as the GL_TEXTURE_2D texture object of a texture unit
+	void Bind(unsigned int unit = 0) const;
+};
+
+// Where one image lies in a texture atlas, in pixels (see atlas_packer)
+struct AtlasRegion
+{
+	const char *Name;
+	unsigned int X, Y, Width, Height;
 };
 
 #endif //TEXTURE_H
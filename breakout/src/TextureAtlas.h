@@ -0,0 +1,28 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+// Generated by atlas_packer from the images named below. Don't edit; edit
+// the images and rebuild instead.
+
+#include "Texture.h"
+
+// 1790x774 pixels
+inline constexpr char TEXTURE_ATLAS_FILE[] = "assets/textures/atlas.tga";
+
+inline constexpr AtlasRegion TEXTURE_ATLAS_REGIONS[] = {
+	{ "face", 1, 1, 512, 512 }, // assets/textures/awesomeface.png
+	{ "block", 1017, 1, 128, 128 }, // assets/textures/block.png
+	{ "block_solid", 1147, 1, 128, 128 }, // assets/textures/block_solid.png
+	{ "paddle", 1277, 1, 512, 128 }, // assets/textures/paddle.png
+	{ "particle", 515, 1, 500, 500 }, // assets/textures/particle.png
+	{ "chaos", 1, 515, 512, 128 }, // assets/textures/powerup_chaos.png
+	{ "confuse", 515, 515, 512, 128 }, // assets/textures/powerup_confuse.png
+	{ "increase", 1029, 515, 512, 128 }, // assets/textures/powerup_increase.png
+	{ "passthrough", 1, 645, 512, 128 }, // assets/textures/powerup_passthrough.png
+	{ "speed", 515, 645, 512, 128 }, // assets/textures/powerup_speed.png
+	{ "sticky", 1029, 645, 512, 128 }, // assets/textures/powerup_sticky.png
+};
+
+inline constexpr unsigned int TEXTURE_ATLAS_REGION_COUNT = 11;
+
+#endif // !TEXTURE_ATLAS_H